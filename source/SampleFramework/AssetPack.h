@@ -0,0 +1,38 @@
+/*
+** Sample Framework for deko3d Applications
+**   AssetPack.h: Asset pack file format definitions
+*/
+#pragma once
+#include <stdint.h>
+
+// This header is deliberately self-contained so that host tools can use it too
+
+// Asset packs bundle arbitrary romfs files behind a table of contents sorted by path.
+// Every entry starts at an offset aligned to its own alignment requirement, so that a positioned
+// read into a slice allocated with the same alignment leaves the data ready to be used by the GPU.
+
+constexpr uint32_t DKPK_MAGIC = 0x4B504B44; // 'DKPK'
+constexpr uint32_t DKPK_PATH_LEN = 112;
+
+constexpr uint32_t DKPK_ALIGNMENT_DEFAULT = 0x20; // DK_IMAGE_LINEAR_STRIDE_ALIGNMENT
+constexpr uint32_t DKPK_ALIGNMENT_SHADER = 0x100; // DK_SHADER_CODE_ALIGNMENT
+
+struct DkpkHeader
+{
+    uint32_t magic; // DKPK_MAGIC
+    uint32_t header_sz; // sizeof(DkpkHeader)
+    uint32_t num_entries;
+    uint32_t data_off; // Offset of the first entry's data
+};
+
+struct DkpkEntry
+{
+    char path[DKPK_PATH_LEN]; // NUL-terminated path relative to the romfs root, e.g. "shaders/basic_vsh.dksh"
+    uint32_t offset; // Relative to the start of the pack, aligned to alignment
+    uint32_t size;
+    uint32_t alignment;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(DkpkHeader) == 16, "Bad DkpkHeader size");
+static_assert(sizeof(DkpkEntry) == 128, "Bad DkpkEntry size");
@@ -0,0 +1,119 @@
+/*
+** Sample Framework for deko3d Applications
+**   CAssetPack.cpp: Utility class for reading files out of an asset pack
+*/
+#include "CAssetPack.h"
+#include "AssetPack.h"
+
+static_assert(DKPK_ALIGNMENT_DEFAULT == DK_IMAGE_LINEAR_STRIDE_ALIGNMENT, "Asset pack alignment mismatch");
+static_assert(DKPK_ALIGNMENT_SHADER == DK_SHADER_CODE_ALIGNMENT, "Asset pack alignment mismatch");
+
+bool CAssetPack::open(const char* path)
+{
+    DkpkHeader hdr;
+    uint32_t fsize;
+
+    close();
+
+    m_file = fopen(path, "rb");
+    if (!m_file) return false;
+
+    fseek(m_file, 0, SEEK_END);
+    fsize = ftell(m_file);
+    rewind(m_file);
+
+    if (!fread(&hdr, sizeof(hdr), 1, m_file))
+        goto _fail0;
+
+    if (hdr.magic != DKPK_MAGIC || hdr.header_sz != sizeof(DkpkHeader) || !hdr.num_entries ||
+        hdr.data_off > fsize || hdr.header_sz + hdr.num_entries*sizeof(DkpkEntry) > hdr.data_off)
+        goto _fail0;
+
+    m_entries = (DkpkEntry*)::malloc(hdr.num_entries*sizeof(DkpkEntry));
+    if (!m_entries)
+        goto _fail0;
+
+    if (!fread(m_entries, hdr.num_entries*sizeof(DkpkEntry), 1, m_file))
+        goto _fail1;
+
+    for (uint32_t i = 0; i < hdr.num_entries; i ++)
+    {
+        DkpkEntry& entry = m_entries[i];
+        entry.path[DKPK_PATH_LEN-1] = 0;
+        if (entry.offset > fsize || entry.size > fsize - entry.offset)
+            goto _fail1;
+    }
+
+    m_numEntries = hdr.num_entries;
+    return true;
+
+_fail1:
+    ::free(m_entries);
+    m_entries = nullptr;
+_fail0:
+    fclose(m_file);
+    m_file = nullptr;
+    return false;
+}
+
+void CAssetPack::close()
+{
+    if (m_file)
+    {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+
+    ::free(m_entries);
+    m_entries = nullptr;
+    m_numEntries = 0;
+}
+
+DkpkEntry const* CAssetPack::findEntry(const char* path) const
+{
+    // The table of contents is sorted by path
+    uint32_t lo = 0, hi = m_numEntries;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        int cmp = strcmp(path, m_entries[mid].path);
+        if (cmp == 0)
+            return &m_entries[mid];
+        if (cmp < 0)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return nullptr;
+}
+
+uint32_t CAssetPack::getSize(const char* path) const
+{
+    DkpkEntry const* entry = findEntry(path);
+    return entry ? entry->size : 0;
+}
+
+CMemPool::Handle CAssetPack::load(CMemPool& pool, const char* path, uint32_t alignment)
+{
+    DkpkEntry const* entry = findEntry(path);
+    if (!entry || !entry->size)
+        return nullptr;
+
+    if (entry->alignment > alignment)
+        alignment = entry->alignment;
+
+    CMemPool::Handle mem = pool.allocate(entry->size, alignment);
+    if (!mem)
+        return nullptr;
+
+    bool ok;
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        ok = fseek(m_file, entry->offset, SEEK_SET) == 0 && fread(mem.getCpuAddr(), entry->size, 1, m_file) == 1;
+    }
+
+    if (!ok)
+        mem.destroy();
+
+    return mem;
+}
@@ -0,0 +1,50 @@
+/*
+** Sample Framework for deko3d Applications
+**   CAssetPack.h: Utility class for reading files out of an asset pack
+*/
+#pragma once
+#include "common.h"
+#include "CMemPool.h"
+
+#include <mutex>
+
+struct DkpkEntry;
+
+class CAssetPack
+{
+    FILE* m_file;
+    DkpkEntry* m_entries;
+    uint32_t m_numEntries;
+    std::mutex m_mutex; // Serializes the seek+read pairs on the shared file
+
+    DkpkEntry const* findEntry(const char* path) const;
+public:
+    CAssetPack() : m_file{}, m_entries{}, m_numEntries{}, m_mutex{} { }
+    ~CAssetPack()
+    {
+        close();
+    }
+
+    CAssetPack(CAssetPack const&) = delete;
+    CAssetPack& operator=(CAssetPack const&) = delete;
+
+    constexpr operator bool() const
+    {
+        return m_file != nullptr;
+    }
+
+    constexpr uint32_t getNumEntries() const
+    {
+        return m_numEntries;
+    }
+
+    // Opens the pack and reads its table of contents; the file stays open until close()
+    bool open(const char* path);
+    void close();
+
+    // Returns the size of the entry at the given path, or 0 if there is no such entry
+    uint32_t getSize(const char* path) const;
+
+    // Reads an entry into a new slice allocated with the entry's alignment (or the given one, if larger)
+    CMemPool::Handle load(CMemPool& pool, const char* path, uint32_t alignment = DK_CMDMEM_ALIGNMENT);
+};
@@ -0,0 +1,113 @@
+/*
+** Sample Framework for deko3d Applications
+**   CAsyncLoader.cpp: Worker thread pool for loading assets in the background
+*/
+#include "CAsyncLoader.h"
+#include "CExternalImage.h"
+#include "CShader.h"
+#include "FileLoader.h"
+
+bool CAsyncLoader::Ticket::isReady() const
+{
+    if (!m_loader)
+        return true;
+    std::lock_guard<std::mutex> lock{m_loader->m_mutex};
+    return m_done;
+}
+
+bool CAsyncLoader::Ticket::wait()
+{
+    if (!m_loader)
+        return m_result;
+    std::unique_lock<std::mutex> lock{m_loader->m_mutex};
+    m_loader->m_jobDone.wait(lock, [this] { return m_done; });
+    return m_result;
+}
+
+CAsyncLoader::CAsyncLoader(unsigned numThreads) : m_stop{}
+{
+    for (unsigned i = 0; i < numThreads; i ++)
+        m_threads.emplace_back(&CAsyncLoader::workerMain, this);
+}
+
+CAsyncLoader::~CAsyncLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stop = true;
+    }
+    m_jobReady.notify_all();
+
+    // Workers drain the queue before exiting, so every pending ticket gets completed
+    for (auto& t : m_threads)
+        t.join();
+}
+
+void CAsyncLoader::workerMain()
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+    for (;;)
+    {
+        m_jobReady.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+        if (m_jobs.empty())
+            break;
+
+        Job job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+
+        lock.unlock();
+        bool result = job.m_func();
+        lock.lock();
+
+        // Completed tickets never touch the loader again, so they may outlive it
+        job.m_ticket->m_result = result;
+        job.m_ticket->m_done = true;
+        job.m_ticket->m_loader = nullptr;
+        m_jobDone.notify_all();
+    }
+}
+
+void CAsyncLoader::submit(Ticket& ticket, std::function<bool()> func)
+{
+    ticket.wait();
+
+    if (m_threads.empty())
+    {
+        // No workers: just run the job synchronously
+        ticket.m_loader = nullptr;
+        ticket.m_result = func();
+        ticket.m_done = true;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        ticket.m_loader = this;
+        ticket.m_done = false;
+        m_jobs.push_back(Job{&ticket, std::move(func)});
+    }
+    m_jobReady.notify_one();
+}
+
+void CAsyncLoader::loadShader(Ticket& ticket, CShader& shader, CMemPool& pool, const char* path)
+{
+    submit(ticket, [&shader, &pool, path] { return shader.loadShared(pool, path); });
+}
+
+void CAsyncLoader::loadFile(Ticket& ticket, CMemPool::Handle& out, CMemPool& pool, const char* path, uint32_t alignment)
+{
+    submit(ticket, [&out, &pool, path, alignment]
+    {
+        out = LoadFile(pool, path, alignment);
+        return bool(out);
+    });
+}
+
+void CAsyncLoader::loadImage(Ticket& ticket, CExternalImage& image, CMemPool& imagePool, CStagingRing& ring, dk::Device device,
+    const char* path, uint32_t width, uint32_t height, DkImageFormat format, uint32_t flags)
+{
+    submit(ticket, [=, &image, &imagePool, &ring]
+    {
+        return image.load(ring, imagePool, device, path, width, height, format, flags);
+    });
+}
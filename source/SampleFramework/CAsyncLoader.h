@@ -0,0 +1,73 @@
+/*
+** Sample Framework for deko3d Applications
+**   CAsyncLoader.h: Worker thread pool for loading assets in the background
+*/
+#pragma once
+#include "common.h"
+#include "CMemPool.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class CShader;
+class CExternalImage;
+class CStagingRing;
+
+class CAsyncLoader
+{
+public:
+    // Completion handle for a single job; it must outlive the job, but once completed it no longer refers to the loader
+    class Ticket
+    {
+        friend class CAsyncLoader;
+        CAsyncLoader* m_loader;
+        bool m_done;
+        bool m_result;
+    public:
+        Ticket() : m_loader{}, m_done{true}, m_result{} { }
+        Ticket(Ticket const&) = delete;
+        Ticket& operator=(Ticket const&) = delete;
+        ~Ticket() { wait(); }
+
+        bool isReady() const;
+
+        // Blocks until the job is done, returning whether it succeeded
+        bool wait();
+    };
+
+private:
+    struct Job
+    {
+        Ticket* m_ticket;
+        std::function<bool()> m_func;
+    };
+
+    std::mutex m_mutex;
+    std::condition_variable m_jobReady;
+    std::condition_variable m_jobDone;
+    std::deque<Job> m_jobs;
+    std::vector<std::thread> m_threads;
+    bool m_stop;
+
+    void workerMain();
+
+public:
+    CAsyncLoader(unsigned numThreads = 2);
+    ~CAsyncLoader();
+
+    // Queues an arbitrary job. Everything it references (including path strings) must stay alive until
+    // the ticket completes. Pools used by jobs must not be destroyed in the meantime either.
+    void submit(Ticket& ticket, std::function<bool()> func);
+
+    void loadShader(Ticket& ticket, CShader& shader, CMemPool& pool, const char* path);
+    void loadFile(Ticket& ticket, CMemPool::Handle& out, CMemPool& pool, const char* path, uint32_t alignment = DK_CMDMEM_ALIGNMENT);
+
+    // The staging ring is used from the worker thread without locking, so it must not be in use elsewhere
+    // (including by other image loads) until the ticket completes
+    void loadImage(Ticket& ticket, CExternalImage& image, CMemPool& imagePool, CStagingRing& ring, dk::Device device,
+        const char* path, uint32_t width, uint32_t height, DkImageFormat format, uint32_t flags = 0);
+};
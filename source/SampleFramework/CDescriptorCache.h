@@ -0,0 +1,140 @@
+/*
+** Sample Framework for deko3d Applications
+**   CDescriptorCache.h: Deduplicating image/sampler descriptor cache
+*/
+#pragma once
+#include "common.h"
+#include "CDescriptorSet.h"
+
+template <unsigned NumDescriptors>
+class CDescriptorCache
+{
+    static constexpr size_t DescriptorSize = sizeof(DkImageDescriptor);
+    static constexpr uint32_t NoSlot = UINT32_MAX;
+
+    static constexpr unsigned calcNumBuckets()
+    {
+        unsigned n = 1;
+        while (n < NumDescriptors)
+            n <<= 1;
+        return n;
+    }
+
+    static constexpr unsigned NumBuckets = calcNumBuckets();
+
+    struct Slot
+    {
+        uint32_t m_hash;
+        uint32_t m_refCount;
+        uint32_t m_next; // Next slot in the same bucket, or next free slot
+        uint32_t m_data[DescriptorSize / sizeof(uint32_t)];
+    };
+
+    CDescriptorSet<NumDescriptors> m_set;
+    Slot m_slots[NumDescriptors];
+    uint32_t m_buckets[NumBuckets];
+    uint32_t m_freeList;
+
+    static uint32_t hash(void const* data)
+    {
+        // FNV-1a over the raw descriptor words
+        uint32_t const* words = static_cast<uint32_t const*>(data);
+        uint32_t h = 2166136261U;
+        for (size_t i = 0; i < DescriptorSize / sizeof(uint32_t); i ++)
+        {
+            h ^= words[i];
+            h *= 16777619U;
+        }
+        return h;
+    }
+
+    void reset()
+    {
+        for (unsigned i = 0; i < NumBuckets; i ++)
+            m_buckets[i] = NoSlot;
+        for (unsigned i = 0; i < NumDescriptors; i ++)
+        {
+            m_slots[i].m_refCount = 0;
+            m_slots[i].m_next = i + 1 < NumDescriptors ? i + 1 : NoSlot;
+        }
+        m_freeList = 0;
+    }
+
+public:
+    static constexpr uint32_t InvalidId = NoSlot;
+
+    CDescriptorCache() : m_set{} { reset(); }
+
+    bool allocate(CMemPool& pool)
+    {
+        reset();
+        return m_set.allocate(pool);
+    }
+
+    void bindForImages(dk::CmdBuf cmdbuf)
+    {
+        m_set.bindForImages(cmdbuf);
+    }
+
+    void bindForSamplers(dk::CmdBuf cmdbuf)
+    {
+        m_set.bindForSamplers(cmdbuf);
+    }
+
+    // Returns the slot holding an identical descriptor if there is one (taking a new reference to it),
+    // otherwise claims a free slot and records the descriptor update. Returns InvalidId when full.
+    template <typename T>
+    uint32_t acquire(dk::CmdBuf cmdbuf, T const& descriptor)
+    {
+        static_assert(sizeof(T) == DescriptorSize);
+        uint32_t h = hash(&descriptor);
+        uint32_t& bucket = m_buckets[h & (NumBuckets - 1)];
+
+        for (uint32_t id = bucket; id != NoSlot; id = m_slots[id].m_next)
+        {
+            Slot& slot = m_slots[id];
+            if (slot.m_hash == h && memcmp(slot.m_data, &descriptor, DescriptorSize) == 0)
+            {
+                slot.m_refCount ++;
+                return id;
+            }
+        }
+
+        uint32_t id = m_freeList;
+        if (id == NoSlot)
+            return InvalidId;
+
+        Slot& slot = m_slots[id];
+        m_freeList = slot.m_next;
+        slot.m_hash = h;
+        slot.m_refCount = 1;
+        slot.m_next = bucket;
+        memcpy(slot.m_data, &descriptor, DescriptorSize);
+        bucket = id;
+
+        m_set.update(cmdbuf, id, descriptor);
+        return id;
+    }
+
+    // Drops a reference to a slot. Once unreferenced the slot may be handed out again by a later
+    // acquire(), so the caller must ensure the GPU is no longer using it by then.
+    void release(uint32_t id)
+    {
+        Slot& slot = m_slots[id];
+        if (!slot.m_refCount || --slot.m_refCount)
+            return;
+
+        uint32_t* point = &m_buckets[slot.m_hash & (NumBuckets - 1)];
+        while (*point != id)
+            point = &m_slots[*point].m_next;
+        *point = slot.m_next;
+
+        slot.m_next = m_freeList;
+        m_freeList = id;
+    }
+
+    constexpr uint32_t getRefCount(uint32_t id) const
+    {
+        return m_slots[id].m_refCount;
+    }
+};
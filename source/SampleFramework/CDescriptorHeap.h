@@ -0,0 +1,169 @@
+/*
+** Sample Framework for deko3d Applications
+**   CDescriptorHeap.h: Runtime-sized image/sampler descriptor heap with deferred slot recycling
+*/
+#pragma once
+#include "common.h"
+#include "CMemPool.h"
+
+template <unsigned NumFrames>
+class CDescriptorHeap
+{
+    static_assert(NumFrames > 0, "Need a non-zero number of frames...");
+    static_assert(sizeof(DkImageDescriptor) == sizeof(DkSamplerDescriptor), "shouldn't happen");
+    static_assert(DK_IMAGE_DESCRIPTOR_ALIGNMENT == DK_SAMPLER_DESCRIPTOR_ALIGNMENT, "shouldn't happen");
+    static constexpr size_t DescriptorSize = sizeof(DkImageDescriptor);
+    static constexpr size_t DescriptorAlign = DK_IMAGE_DESCRIPTOR_ALIGNMENT;
+    static constexpr uint32_t NoSlot = UINT32_MAX;
+
+    // Slots released during a frame; they become reusable once that frame's fence is signaled
+    struct Retired
+    {
+        dk::Fence m_fence;
+        uint32_t m_first;
+        uint32_t m_last;
+    };
+
+    CMemPool::Handle m_mem;
+    uint32_t m_capacity;
+    uint32_t* m_links;
+    uint32_t m_freeList;
+    unsigned m_curFrame;
+    Retired m_retired[NumFrames];
+
+    void reclaim(Retired& r)
+    {
+        if (r.m_first == NoSlot)
+            return;
+
+        m_links[r.m_last] = m_freeList;
+        m_freeList = r.m_first;
+        r.m_first = r.m_last = NoSlot;
+    }
+
+    void destroy()
+    {
+        m_mem.destroy();
+        ::free(m_links);
+        m_links = nullptr;
+        m_capacity = 0;
+    }
+
+public:
+    static constexpr uint32_t InvalidId = NoSlot;
+
+    CDescriptorHeap() : m_mem{}, m_capacity{}, m_links{}, m_freeList{NoSlot}, m_curFrame{}, m_retired{}
+    {
+        for (unsigned i = 0; i < NumFrames; i ++)
+            m_retired[i].m_first = m_retired[i].m_last = NoSlot;
+    }
+
+    ~CDescriptorHeap()
+    {
+        destroy();
+    }
+
+    bool allocate(CMemPool& pool, uint32_t capacity)
+    {
+        destroy();
+        if (!capacity)
+            return false;
+
+        m_links = (uint32_t*)::malloc(capacity*sizeof(uint32_t));
+        if (!m_links)
+            return false;
+
+        m_mem = pool.allocate(capacity*DescriptorSize, DescriptorAlign);
+        if (!m_mem)
+        {
+            destroy();
+            return false;
+        }
+
+        m_capacity = capacity;
+        for (uint32_t i = 0; i < capacity; i ++)
+            m_links[i] = i + 1 < capacity ? i + 1 : NoSlot;
+        m_freeList = 0;
+        m_curFrame = 0;
+        for (unsigned i = 0; i < NumFrames; i ++)
+        {
+            m_retired[i].m_fence = dk::Fence{};
+            m_retired[i].m_first = m_retired[i].m_last = NoSlot;
+        }
+        return true;
+    }
+
+    constexpr uint32_t getCapacity() const
+    {
+        return m_capacity;
+    }
+
+    void bindForImages(dk::CmdBuf cmdbuf)
+    {
+        cmdbuf.bindImageDescriptorSet(m_mem.getGpuAddr(), m_capacity);
+    }
+
+    void bindForSamplers(dk::CmdBuf cmdbuf)
+    {
+        cmdbuf.bindSamplerDescriptorSet(m_mem.getGpuAddr(), m_capacity);
+    }
+
+    // Hands out a free slot, or InvalidId if every slot is either in use or still awaiting its fence
+    uint32_t alloc()
+    {
+        if (m_freeList == NoSlot)
+        {
+            // Opportunistically pick up slots from frames the GPU has already finished
+            for (unsigned i = 0; i < NumFrames; i ++)
+                if (i != m_curFrame && m_retired[i].m_first != NoSlot && m_retired[i].m_fence.wait(0) == DkResult_Success)
+                    reclaim(m_retired[i]);
+        }
+
+        uint32_t id = m_freeList;
+        if (id != NoSlot)
+            m_freeList = m_links[id];
+        return id;
+    }
+
+    // Releases a slot; it is only handed out again after the fence of the current frame is signaled
+    void release(uint32_t id)
+    {
+        Retired& r = m_retired[m_curFrame];
+        m_links[id] = NoSlot;
+        if (r.m_last != NoSlot)
+            m_links[r.m_last] = id;
+        else
+            r.m_first = id;
+        r.m_last = id;
+    }
+
+    template <typename T>
+    void update(dk::CmdBuf cmdbuf, uint32_t id, T const& descriptor)
+    {
+        static_assert(sizeof(T) == DescriptorSize);
+        cmdbuf.pushData(m_mem.getGpuAddr() + id*DescriptorSize, &descriptor, DescriptorSize);
+    }
+
+    // Must be called at the start of every frame, after the previous frame's commands have been submitted
+    void beginFrame()
+    {
+        // Slots still waiting on the fence of this frame index must be reclaimed before it gets signaled
+        // again (this only blocks if the GPU is NumFrames frames behind)
+        Retired& r = m_retired[m_curFrame];
+        if (r.m_first != NoSlot)
+        {
+            r.m_fence.wait();
+            reclaim(r);
+        }
+    }
+
+    // Must be recorded at the end of every frame's commands that reference this heap, before submitting them
+    void endFrame(dk::CmdBuf cmdbuf)
+    {
+        // Signal the fence covering every slot released during this frame
+        cmdbuf.signalFence(m_retired[m_curFrame].m_fence);
+
+        // Advance to the next frame, wrapping around when we reach the end
+        m_curFrame = (m_curFrame + 1) % NumFrames;
+    }
+};
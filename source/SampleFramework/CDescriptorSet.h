@@ -68,4 +68,41 @@ public:
 		static_assert(sizeof(T) == DescriptorSize);
 		cmdbuf.pushData(m_mem.getGpuAddr() + id*DescriptorSize, descriptors.data(), descriptors.size()*DescriptorSize);
 	}
+
+	// Direct CPU-write path: stores descriptors straight into the set's memory instead of going through
+	// the command buffer. Only usable when the backing memory is CPU-mapped (CpuCached memory must also
+	// be flushed by the caller). Unlike update(), the writes are not ordered with respect to submitted
+	// commands, so the GPU must not be using the affected slots; and invalidate() must be recorded
+	// before the GPU uses the new descriptors.
+
+	bool isCpuVisible() const
+	{
+		return m_mem && m_mem.getCpuAddr() != nullptr;
+	}
+
+	template <typename T>
+	void write(uint32_t id, T const& descriptor)
+	{
+		static_assert(sizeof(T) == DescriptorSize);
+		memcpy(static_cast<u8*>(m_mem.getCpuAddr()) + id*DescriptorSize, &descriptor, DescriptorSize);
+	}
+
+	template <typename T, size_t N>
+	void write(uint32_t id, std::array<T, N> const& descriptors)
+	{
+		static_assert(sizeof(T) == DescriptorSize);
+		memcpy(static_cast<u8*>(m_mem.getCpuAddr()) + id*DescriptorSize, descriptors.data(), descriptors.size()*DescriptorSize);
+	}
+
+	template <typename T>
+	void write(uint32_t id, std::initializer_list<T const> const& descriptors)
+	{
+		static_assert(sizeof(T) == DescriptorSize);
+		memcpy(static_cast<u8*>(m_mem.getCpuAddr()) + id*DescriptorSize, descriptors.begin(), descriptors.size()*DescriptorSize);
+	}
+
+	void invalidate(dk::CmdBuf cmdbuf)
+	{
+		cmdbuf.barrier(DkBarrier_None, DkInvalidateFlags_Descriptors);
+	}
 };
@@ -3,18 +3,32 @@
 **   CExternalImage.cpp: Utility class for loading images from the filesystem
 */
 #include "CExternalImage.h"
-#include "FileLoader.h"
+#include "CReleaseQueue.h"
+#include "CStagingRing.h"
+#include "CUploadBatch.h"
+#include "CUploadTicket.h"
 
-bool CExternalImage::load(CMemPool& imagePool, CMemPool& scratchPool, dk::Device device, dk::Queue transferQueue, const char* path, uint32_t width, uint32_t height, DkImageFormat format, uint32_t flags)
+void CExternalImage::release(CReleaseQueue* releaseQueue)
 {
-    CMemPool::Handle tempimgmem = LoadFile(scratchPool, path, DK_IMAGE_LINEAR_STRIDE_ALIGNMENT);
-    if (!tempimgmem)
-        return false;
+    // The memory can't go away under a non-blocking upload that is still writing it
+    if (m_mem && m_uploadPending)
+    {
+        if (releaseQueue)
+        {
+            releaseQueue->retire(m_uploadFence, m_mem);
+            m_mem = nullptr;
+        }
+        else
+            m_uploadFence.wait();
+    }
 
-    dk::UniqueCmdBuf tempcmdbuf = dk::CmdBufMaker{device}.create();
-    CMemPool::Handle tempcmdmem = scratchPool.allocate(DK_MEMBLOCK_ALIGNMENT);
-    tempcmdbuf.addMemory(tempcmdmem.getMemBlock(), tempcmdmem.getOffset(), tempcmdmem.getSize());
+    m_mem.destroy();
+    m_uploadPending = false;
+}
 
+bool CExternalImage::initialize(CMemPool& imagePool, dk::Device device, uint32_t width, uint32_t height, DkImageFormat format, uint32_t flags,
+    CReleaseQueue* releaseQueue)
+{
     dk::ImageLayout layout;
     dk::ImageLayoutMaker{device}
         .setFlags(flags)
@@ -22,16 +36,65 @@ bool CExternalImage::load(CMemPool& imagePool, CMemPool& scratchPool, dk::Device
         .setDimensions(width, height)
         .initialize(layout);
 
+    release(releaseQueue);
     m_mem = imagePool.allocate(layout.getSize(), layout.getAlignment());
+    if (!m_mem)
+        return false;
+
     m_image.initialize(layout, m_mem.getMemBlock(), m_mem.getOffset());
     m_descriptor.initialize(m_image);
+    return true;
+}
+
+bool CExternalImage::load(CUploadBatch& batch, CStagingRing& ring, CMemPool& imagePool, dk::Device device, const char* path, uint32_t width, uint32_t height, DkImageFormat format, uint32_t flags)
+{
+    if (batch.isFull())
+        return false;
+
+    // A span that isn't handed to the batch is simply reused by the ring later
+    CStagingRing::Span span = ring.readFile(path);
+    if (!span || !initialize(imagePool, device, width, height, format, flags))
+        return false;
+
+    dk::ImageView imageView{m_image};
+    return batch.copyBufferToImage(ring, span, imageView, { 0, 0, 0, width, height, 1 });
+}
+
+bool CExternalImage::load(CUploadBatch& batch, CMemPool& imagePool, CMemPool::Handle staging, dk::Device device, uint32_t width, uint32_t height, DkImageFormat format, uint32_t flags)
+{
+    if (batch.isFull() || !initialize(imagePool, device, width, height, format, flags))
+        return false;
+
+    dk::ImageView imageView{m_image};
+    return batch.copyBufferToImage(staging, imageView, { 0, 0, 0, width, height, 1 });
+}
+
+bool CExternalImage::load(CStagingRing& ring, CMemPool& imagePool, dk::Device device, const char* path, uint32_t width, uint32_t height, DkImageFormat format, uint32_t flags)
+{
+    CStagingRing::Span span = ring.readFile(path);
+    if (!span || !initialize(imagePool, device, width, height, format, flags))
+        return false;
+
+    dk::ImageView imageView{m_image};
+    ring.commitImage(span, imageView, { 0, 0, 0, width, height, 1 });
+    ring.wait();
+    return true;
+}
+
+bool CExternalImage::load(CUploadTicket& ticket, CReleaseQueue& releaseQueue, CStagingRing& ring, CMemPool& imagePool, dk::Device device, const char* path, uint32_t width, uint32_t height, DkImageFormat format, uint32_t flags)
+{
+    // Give back whatever earlier uploads have finished with
+    releaseQueue.poll();
+
+    CStagingRing::Span span = ring.readFile(path);
+    if (!span || !initialize(imagePool, device, width, height, format, flags, &releaseQueue))
+        return false;
 
     dk::ImageView imageView{m_image};
-    tempcmdbuf.copyBufferToImage({ tempimgmem.getGpuAddr() }, imageView, { 0, 0, 0, width, height, 1 });
-    transferQueue.submitCommands(tempcmdbuf.finishList());
-    transferQueue.waitIdle();
+    ring.commitImage(span, imageView, { 0, 0, 0, width, height, 1 });
+    ring.flush(ticket.arm());
 
-    tempcmdmem.destroy();
-    tempimgmem.destroy();
+    m_uploadFence = ticket.getFence();
+    m_uploadPending = true;
     return true;
 }
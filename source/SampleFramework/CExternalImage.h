@@ -6,16 +6,27 @@
 #include "common.h"
 #include "CMemPool.h"
 
+class CReleaseQueue;
+class CStagingRing;
+class CUploadBatch;
+class CUploadTicket;
+
 class CExternalImage
 {
     dk::Image m_image;
     dk::ImageDescriptor m_descriptor;
     CMemPool::Handle m_mem;
+    dk::Fence m_uploadFence; // Signaled once the last non-blocking upload into m_mem has completed
+    bool m_uploadPending;
+
+    void release(CReleaseQueue* releaseQueue);
+    bool initialize(CMemPool& imagePool, dk::Device device, uint32_t width, uint32_t height, DkImageFormat format, uint32_t flags,
+        CReleaseQueue* releaseQueue = nullptr);
 public:
-    CExternalImage() : m_image{}, m_descriptor{}, m_mem{} { }
+    CExternalImage() : m_image{}, m_descriptor{}, m_mem{}, m_uploadFence{}, m_uploadPending{} { }
     ~CExternalImage()
     {
-        m_mem.destroy();
+        release(nullptr);
     }
 
     constexpr operator bool() const
@@ -33,5 +44,19 @@ public:
         return m_descriptor;
     }
 
-    bool load(CMemPool& imagePool, CMemPool& scratchPool, dk::Device device, dk::Queue transferQueue, const char* path, uint32_t width, uint32_t height, DkImageFormat format, uint32_t flags = 0);
+    // The file is read straight into the staging ring, whose queue uploads it
+    bool load(CStagingRing& ring, CMemPool& imagePool, dk::Device device, const char* path, uint32_t width, uint32_t height, DkImageFormat format, uint32_t flags = 0);
+
+    // Only records the upload into the batch; the image can be used once the batch has completed.
+    // The batch borrows the ring span holding the file until then. Fails without reading the file if the batch is full.
+    bool load(CUploadBatch& batch, CStagingRing& ring, CMemPool& imagePool, dk::Device device, const char* path, uint32_t width, uint32_t height, DkImageFormat format, uint32_t flags = 0);
+
+    // Same, but from image data already loaded into staging (e.g. by CAssetPack::load), which the batch takes
+    // ownership of. The staging slice is left alone if this fails.
+    bool load(CUploadBatch& batch, CMemPool& imagePool, CMemPool::Handle staging, dk::Device device, uint32_t width, uint32_t height, DkImageFormat format, uint32_t flags = 0);
+
+    // Submits the upload and returns without waiting for it; the ticket tells when the image is usable.
+    // The ring retires the file's span with the same submission. The image memory replaced by this load is
+    // handed to releaseQueue if an earlier non-blocking upload may still be writing it.
+    bool load(CUploadTicket& ticket, CReleaseQueue& releaseQueue, CStagingRing& ring, CMemPool& imagePool, dk::Device device, const char* path, uint32_t width, uint32_t height, DkImageFormat format, uint32_t flags = 0);
 };
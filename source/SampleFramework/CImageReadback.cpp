@@ -0,0 +1,66 @@
+/*
+** Sample Framework for deko3d Applications
+**   CImageReadback.cpp: Copies images back to the CPU for checksumming and comparison
+*/
+#include "CImageReadback.h"
+
+#include <vector>
+
+bool CImageReadback::allocate(CMemPool& pool, dk::Device device, uint32_t width, uint32_t height, DkImageFormat format, uint32_t bytesPerPixel)
+{
+    dk::ImageLayout layout;
+    dk::ImageLayoutMaker{device}
+        .setFlags(DkImageFlags_CustomTileSize)
+        .setFormat(format)
+        .setDimensions(width, height)
+        .setTileSize(TileSize)
+        .initialize(layout);
+
+    m_mem.destroy();
+    m_mem = pool.allocate(layout.getSize(), layout.getAlignment());
+    if (!m_mem)
+        return false;
+
+    m_image.initialize(layout, m_mem.getMemBlock(), m_mem.getOffset());
+    m_surf = SwizzleSurface{width, height, bytesPerPixel, uint32_t(TileSize)};
+    return true;
+}
+
+void CImageReadback::capture(dk::CmdBuf cmdbuf, dk::ImageView const& src)
+{
+    DkImageRect rect = { 0, 0, 0, m_surf.width, m_surf.height, 1 };
+    cmdbuf.copyImage(src, rect, dk::ImageView{m_image}, rect);
+}
+
+void const* CImageReadback::prepare()
+{
+    // Drop any stale lines so that the CPU sees what the GPU wrote
+    m_mem.getMemBlock().flushCpuCache(m_mem.getOffset(), m_mem.getSize());
+    return m_mem.getCpuAddr();
+}
+
+void CImageReadback::read(void* dst, uint32_t pitch)
+{
+    DeswizzleImage(m_surf, dst, pitch, prepare());
+}
+
+void CImageReadback::read(void* dst, uint32_t pitch, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+    DeswizzleRect(m_surf, dst, pitch, prepare(), x, y, width, height);
+}
+
+uint32_t CImageReadback::checksum()
+{
+    void const* src = prepare();
+    uint32_t rowSize = m_surf.width * m_surf.bytesPerPixel;
+    std::vector<uint8_t> row(rowSize);
+
+    uint32_t hash = 0x811C9DC5;
+    for (uint32_t y = 0; y < m_surf.height; y ++)
+    {
+        DeswizzleRect(m_surf, row.data(), rowSize, src, 0, y, m_surf.width, 1);
+        for (uint32_t i = 0; i < rowSize; i ++)
+            hash = (hash ^ row[i]) * 0x01000193;
+    }
+    return hash;
+}
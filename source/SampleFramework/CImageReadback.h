@@ -0,0 +1,50 @@
+/*
+** Sample Framework for deko3d Applications
+**   CImageReadback.h: Copies images back to the CPU for checksumming and comparison
+*/
+#pragma once
+#include "common.h"
+#include "CMemPool.h"
+#include "Swizzle.h"
+
+class CImageReadback
+{
+    // Every image is captured with this tile size, so the CPU side knows the block height
+    static constexpr DkTileSize TileSize = DkTileSize_SixteenGobs;
+
+    dk::Image m_image;
+    CMemPool::Handle m_mem;
+    SwizzleSurface m_surf;
+
+    void const* prepare();
+public:
+    CImageReadback() : m_image{}, m_mem{}, m_surf{} { }
+    ~CImageReadback()
+    {
+        m_mem.destroy();
+    }
+
+    constexpr operator bool() const
+    {
+        return m_mem;
+    }
+
+    constexpr SwizzleSurface const& getSurface() const
+    {
+        return m_surf;
+    }
+
+    // The pool should be CpuCached | GpuCached | Image, reading uncached memory back is very slow
+    bool allocate(CMemPool& pool, dk::Device device, uint32_t width, uint32_t height, DkImageFormat format, uint32_t bytesPerPixel);
+
+    // Records a copy of the source into the readback image. The source may be a compressed render target,
+    // the copy decompresses it into a plain block-linear image.
+    void capture(dk::CmdBuf cmdbuf, dk::ImageView const& src);
+
+    // Only valid once the captured copy has completed (e.g. after waiting for the queue to be idle)
+    void read(void* dst, uint32_t pitch);
+    void read(void* dst, uint32_t pitch, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+
+    // FNV-1a hash of the pixels in row order, which doesn't depend on the memory layout
+    uint32_t checksum();
+};
@@ -22,12 +22,21 @@ CMemPool::~CMemPool()
     m_memMap.iterate([](Slice* s) { ::free(s); });
     m_sliceHeap.iterate([](Slice* s) { ::free(s); });
     m_blocks.iterate([](Block* blk) {
+        uint32_t size = blk->m_obj.getSize();
         blk->m_obj.destroy();
+        if (blk->m_release)
+            blk->m_release(blk->m_storage, size);
         ::free(blk);
     });
 }
 
 auto CMemPool::allocate(uint32_t size, uint32_t alignment) -> Handle
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return _allocate(size, alignment);
+}
+
+auto CMemPool::_allocate(uint32_t size, uint32_t alignment) -> Slice*
 {
     if (!size) return nullptr;
     if (alignment & (alignment - 1)) return nullptr;
@@ -95,6 +104,8 @@ auto CMemPool::allocate(uint32_t size, uint32_t alignment) -> Handle
 
         blk->m_cpuAddr = blk->m_obj.getCpuAddr();
         blk->m_gpuAddr = blk->m_obj.getGpuAddr();
+        blk->m_release = nullptr;
+        blk->m_storage = nullptr;
         m_blocks.add(blk);
 
         start_offset = 0;
@@ -148,10 +159,64 @@ _bad:
     return nullptr;
 }
 
+auto CMemPool::import(void* storage, uint32_t size, ReleaseFunc release, uint32_t usedSize) -> Handle
+{
+    if (!storage || !size || usedSize > size) return nullptr;
+    if (((uintptr_t)storage | size) & (DK_MEMBLOCK_ALIGNMENT - 1)) return nullptr;
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    Block* blk = (Block*)::malloc(sizeof(Block));
+    if (!blk)
+        return nullptr;
+
+    Slice* slice = _newSlice();
+    if (!slice)
+        goto _fail0;
+
+    blk->m_obj = dk::MemBlockMaker{m_dev, size}.setFlags(m_flags).setStorage(storage).create();
+    if (!blk->m_obj)
+        goto _fail1;
+
+    blk->m_cpuAddr = blk->m_obj.getCpuAddr();
+    blk->m_gpuAddr = blk->m_obj.getGpuAddr();
+    blk->m_release = release;
+    blk->m_storage = storage;
+    m_blocks.add(blk);
+
+    // Imported blocks hold exactly one slice and never take part in suballocation
+    slice->m_pool = this;
+    slice->m_block = blk;
+    slice->m_start = 0;
+    slice->m_end = usedSize ? usedSize : size;
+    m_memMap.add(slice);
+    return slice;
+
+_fail1:
+    _deleteSlice(slice);
+_fail0:
+    ::free(blk);
+    return nullptr;
+}
+
 void CMemPool::_destroy(Slice* slice)
 {
+    std::lock_guard<std::mutex> lock{m_mutex};
     slice->m_pool = nullptr;
 
+    Block* blk = slice->m_block;
+    if (blk->m_release)
+    {
+        uint32_t size = blk->m_obj.getSize();
+        m_memMap.remove(slice);
+        _deleteSlice(slice);
+        m_blocks.remove(blk);
+        blk->m_obj.destroy();
+        blk->m_release(blk->m_storage, size);
+        ::free(blk);
+        return;
+    }
+
     Slice* left  = m_memMap.prev(slice);
     Slice* right = m_memMap.next(slice);
 
@@ -7,11 +7,18 @@
 #include "CIntrusiveList.h"
 #include "CIntrusiveTree.h"
 
+#include <mutex>
+
 class CMemPool
 {
+public:
+    using ReleaseFunc = void (*)(void* storage, uint32_t size);
+
+private:
     dk::Device m_dev;
     uint32_t m_flags;
     uint32_t m_blockSize;
+    std::mutex m_mutex; // Allows handles to be allocated and destroyed from worker threads
 
     struct Block
     {
@@ -19,6 +26,8 @@ class CMemPool
         dk::MemBlock m_obj;
         void* m_cpuAddr;
         DkGpuAddr m_gpuAddr;
+        ReleaseFunc m_release; // Only set for blocks created on top of imported storage
+        void* m_storage;
 
         constexpr void* cpuOffset(uint32_t offset) const
         {
@@ -57,6 +66,7 @@ class CMemPool
     Slice* _newSlice();
     void _deleteSlice(Slice*);
 
+    Slice* _allocate(uint32_t size, uint32_t alignment);
     void _destroy(Slice* slice);
 
 public:
@@ -108,10 +118,15 @@ public:
     };
 
     CMemPool(dk::Device dev, uint32_t flags = DkMemBlockFlags_CpuUncached | DkMemBlockFlags_GpuCached, uint32_t blockSize = DefaultBlockSize) :
-        m_dev{dev}, m_flags{flags}, m_blockSize{blockSize}, m_blocks{}, m_memMap{}, m_sliceHeap{}, m_freeList{} { }
+        m_dev{dev}, m_flags{flags}, m_blockSize{blockSize}, m_mutex{}, m_blocks{}, m_memMap{}, m_sliceHeap{}, m_freeList{} { }
     ~CMemPool();
 
     Handle allocate(uint32_t size, uint32_t alignment = DK_CMDMEM_ALIGNMENT);
+
+    // Wraps caller-provided storage (aligned to DK_MEMBLOCK_ALIGNMENT) in a dedicated memory block.
+    // The returned handle covers the first usedSize bytes of it, or all of it if usedSize is 0.
+    // release is called with the whole storage once the handle is destroyed.
+    Handle import(void* storage, uint32_t size, ReleaseFunc release, uint32_t usedSize = 0);
 };
 
 constexpr bool operator<(uint32_t lhs, CMemPool::Slice const& rhs)
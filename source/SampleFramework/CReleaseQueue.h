@@ -0,0 +1,63 @@
+/*
+** Sample Framework for deko3d Applications
+**   CReleaseQueue.h: Deferred release of memory still in use by the GPU
+*/
+#pragma once
+#include "common.h"
+#include "CMemPool.h"
+
+#include <deque>
+#include <mutex>
+
+class CReleaseQueue
+{
+    struct Entry
+    {
+        dk::Fence m_fence;
+        CMemPool::Handle m_mem;
+    };
+
+    std::mutex m_mutex;
+    std::deque<Entry> m_entries; // In submission order
+
+public:
+    CReleaseQueue() : m_mutex{}, m_entries{} { }
+    ~CReleaseQueue()
+    {
+        flush();
+    }
+
+    CReleaseQueue(CReleaseQueue const&) = delete;
+    CReleaseQueue& operator=(CReleaseQueue const&) = delete;
+
+    // Destroys the handle once the fence has been signaled
+    void retire(dk::Fence const& fence, CMemPool::Handle mem)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_entries.push_back(Entry{fence, mem});
+    }
+
+    // Frees everything whose fence has already been signaled, without blocking. Fences on one queue
+    // signal in order, so this stops at the first one still pending.
+    void poll()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        while (!m_entries.empty() && m_entries.front().m_fence.wait(0) == DkResult_Success)
+        {
+            m_entries.front().m_mem.destroy();
+            m_entries.pop_front();
+        }
+    }
+
+    // Waits for and frees everything
+    void flush()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        for (auto& entry : m_entries)
+        {
+            entry.m_fence.wait();
+            entry.m_mem.destroy();
+        }
+        m_entries.clear();
+    }
+};
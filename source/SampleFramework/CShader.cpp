@@ -3,60 +3,122 @@
 **   CShader.cpp: Utility class for loading shaders from the filesystem
 */
 #include "CShader.h"
+#include "Dksh.h"
 
-struct DkshHeader
+bool CShader::validate(void const* dksh, uint32_t size)
 {
-    uint32_t magic; // DKSH_MAGIC
-    uint32_t header_sz; // sizeof(DkshHeader)
-    uint32_t control_sz;
-    uint32_t code_sz;
-    uint32_t programs_off;
-    uint32_t num_programs;
-};
+    auto hdr = static_cast<DkshHeader const*>(dksh);
+    return size >= sizeof(DkshHeader) && hdr->magic == DKSH_MAGIC && !(hdr->control_sz & (DK_SHADER_CODE_ALIGNMENT - 1)) &&
+        uint64_t(hdr->control_sz) + hdr->code_sz <= size && hdr->num_programs && hdr->num_programs <= MaxPrograms &&
+        hdr->programs_off + hdr->num_programs*sizeof(DkshProgramHeader) <= hdr->control_sz;
+}
+
+void CShader::initialize(CMemPool::Handle const& code, void const* control)
+{
+    // The control section is only read here, deko3d keeps what it needs in dk::Shader
+    auto hdr = static_cast<DkshHeader const*>(control);
+    auto progs = reinterpret_cast<DkshProgramHeader const*>(reinterpret_cast<u8 const*>(hdr) + hdr->programs_off);
+    for (uint32_t i = 0; i < hdr->num_programs; i ++)
+    {
+        dk::ShaderMaker{code.getMemBlock(), code.getOffset()}
+            .setControl(hdr)
+            .setProgramId(i)
+            .initialize(m_shaders[i]);
+        m_types[i] = progs[i].type;
+    }
+    m_numPrograms = hdr->num_programs;
+}
+
+void CShader::destroy()
+{
+    m_codemem.destroy();
+    if (m_sharedcode)
+    {
+        CShaderRegistry::get().release(m_sharedcode);
+        m_sharedcode = nullptr;
+    }
+    m_numPrograms = 0;
+}
 
 bool CShader::load(CMemPool& pool, const char* path)
 {
     FILE* f;
-    DkshHeader hdr;
-    void* ctrlmem;
+    uint32_t readSize, codeInBuffer;
+    alignas(DkshHeader) u8 buffer[MaxControlSize];
+    auto hdr = reinterpret_cast<DkshHeader const*>(buffer);
 
-    m_codemem.destroy();
+    destroy();
 
     f = fopen(path, "rb");
     if (!f) return false;
 
-    if (!fread(&hdr, sizeof(hdr), 1, f))
+    // A single read brings in the header and control section, which are parsed from the stack.
+    // Small shaders fit in the buffer whole; otherwise the rest of the code is read by a second fread.
+    readSize = fread(buffer, 1, sizeof(buffer), f);
+    if (readSize < sizeof(DkshHeader) || hdr->control_sz > readSize ||
+        !validate(buffer, readSize < sizeof(buffer) ? readSize : UINT32_MAX))
         goto _fail0;
 
-    ctrlmem = malloc(hdr.control_sz);
-    if (!ctrlmem)
+    m_codemem = pool.allocate(hdr->code_sz, DK_SHADER_CODE_ALIGNMENT);
+    if (!m_codemem)
         goto _fail0;
 
-    rewind(f);
-    if (!fread(ctrlmem, hdr.control_sz, 1, f))
+    // The code section goes to the pool, which is usually uncached and never read back
+    codeInBuffer = readSize - hdr->control_sz;
+    if (codeInBuffer > hdr->code_sz)
+        codeInBuffer = hdr->code_sz;
+    memcpy(m_codemem.getCpuAddr(), buffer + hdr->control_sz, codeInBuffer);
+    if (codeInBuffer < hdr->code_sz &&
+        !fread(static_cast<u8*>(m_codemem.getCpuAddr()) + codeInBuffer, hdr->code_sz - codeInBuffer, 1, f))
         goto _fail1;
 
-    m_codemem = pool.allocate(hdr.code_sz, DK_SHADER_CODE_ALIGNMENT);
-    if (!m_codemem)
-        goto _fail1;
-
-    if (!fread(m_codemem.getCpuAddr(), hdr.code_sz, 1, f))
-        goto _fail2;
-
-    dk::ShaderMaker{m_codemem.getMemBlock(), m_codemem.getOffset()}
-        .setControl(ctrlmem)
-        .setProgramId(0)
-        .initialize(m_shader);
-
-    free(ctrlmem);
+    initialize(m_codemem, buffer);
     fclose(f);
     return true;
 
-_fail2:
-    m_codemem.destroy();
 _fail1:
-    free(ctrlmem);
+    m_codemem.destroy();
 _fail0:
     fclose(f);
     return false;
 }
+
+bool CShader::loadShared(CMemPool& pool, const char* path)
+{
+    destroy();
+
+    m_sharedcode = CShaderRegistry::get().acquire(pool, path);
+    if (!m_sharedcode)
+        return false;
+
+    initialize(m_sharedcode->getMem(), m_sharedcode->getControl());
+    return true;
+}
+
+dk::Shader const* CShader::find(const char* name) const
+{
+    static constexpr struct
+    {
+        const char* name;
+        DkshProgramType type;
+    } stageNames[] =
+    {
+        { "vert",      DkshProgramType_Vertex   },
+        { "tess_ctrl", DkshProgramType_TessCtrl },
+        { "tess_eval", DkshProgramType_TessEval },
+        { "geom",      DkshProgramType_Geometry },
+        { "frag",      DkshProgramType_Fragment },
+        { "comp",      DkshProgramType_Compute  },
+    };
+
+    for (auto const& stage : stageNames)
+    {
+        if (strcmp(name, stage.name) != 0)
+            continue;
+        for (uint32_t i = 0; i < m_numPrograms; i ++)
+            if (m_types[i] == stage.type)
+                return &m_shaders[i];
+        break;
+    }
+    return nullptr;
+}
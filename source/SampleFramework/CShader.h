@@ -5,27 +5,64 @@
 #pragma once
 #include "common.h"
 #include "CMemPool.h"
+#include "CShaderRegistry.h"
 
 class CShader
 {
-    dk::Shader m_shader;
+public:
+    // A DKSH file can hold at most one program per pipeline stage
+    static constexpr uint32_t MaxPrograms = 6;
+
+    // Size of the stack buffer load() reads files into; the control section must fit in it
+    static constexpr uint32_t MaxControlSize = 0x1000;
+
+private:
+    dk::Shader m_shaders[MaxPrograms];
+    uint32_t m_types[MaxPrograms];
+    uint32_t m_numPrograms;
     CMemPool::Handle m_codemem;
+    CShaderRegistry::Code* m_sharedcode;
+
+    void initialize(CMemPool::Handle const& code, void const* control);
+    void destroy();
 public:
-    CShader() : m_shader{}, m_codemem{} { }
+    // Checks that size bytes of DKSH data hold a header and program table CShader can use
+    static bool validate(void const* dksh, uint32_t size);
+
+    CShader() : m_shaders{}, m_types{}, m_numPrograms{}, m_codemem{}, m_sharedcode{} { }
     ~CShader()
     {
-        m_codemem.destroy();
+        destroy();
     }
 
     constexpr operator bool() const
     {
-        return m_codemem;
+        return m_codemem || m_sharedcode;
     }
 
     constexpr operator dk::Shader const*() const
     {
-        return &m_shader;
+        return &m_shaders[0];
     }
 
+    constexpr uint32_t getNumPrograms() const
+    {
+        return m_numPrograms;
+    }
+
+    // Loads every program in the DKSH file, all of them sharing a single code allocation
     bool load(CMemPool& pool, const char* path);
+
+    // Same as load(), but goes through CShaderRegistry: the file is only read once per process,
+    // and identical code already resident in the pool is shared instead of uploaded again
+    bool loadShared(CMemPool& pool, const char* path);
+
+    // Selects a program by its index in the file
+    dk::Shader const* get(uint32_t id) const
+    {
+        return id < m_numPrograms ? &m_shaders[id] : nullptr;
+    }
+
+    // Selects a program by its stage name, as passed to uam -s (vert, tess_ctrl, tess_eval, geom, frag, comp)
+    dk::Shader const* find(const char* name) const;
 };
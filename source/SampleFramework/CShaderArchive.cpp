@@ -0,0 +1,108 @@
+/*
+** Sample Framework for deko3d Applications
+**   CShaderArchive.cpp: Utility class for loading packed shader archives from the filesystem
+*/
+#include "CShaderArchive.h"
+#include "Dksh.h"
+
+static_assert(DKSA_ALIGNMENT == DK_SHADER_CODE_ALIGNMENT, "Shader archive alignment mismatch");
+
+void CShaderArchive::destroy()
+{
+    m_mem.destroy();
+    ::free(m_cpuData);
+    m_cpuData = nullptr;
+    m_numEntries = 0;
+}
+
+bool CShaderArchive::load(CMemPool& pool, const char* path)
+{
+    FILE* f;
+    DksaHeader hdr;
+    uint32_t tocSize;
+    DksaEntry const* entries;
+    u8 const* control;
+
+    destroy();
+
+    f = fopen(path, "rb");
+    if (!f) return false;
+
+    if (!fread(&hdr, sizeof(hdr), 1, f) ||
+        hdr.magic != DKSA_MAGIC || hdr.header_sz != sizeof(DksaHeader) || !hdr.num_entries || !hdr.code_sz ||
+        uint64_t(hdr.num_entries)*sizeof(DksaEntry) + hdr.control_sz > UINT32_MAX)
+        goto _fail0;
+
+    // The table of contents and every control section are read together into CPU memory, where they are parsed
+    tocSize = hdr.num_entries*sizeof(DksaEntry);
+    m_cpuData = (u8*)::malloc(tocSize + hdr.control_sz);
+    if (!m_cpuData || !fread(m_cpuData, tocSize + hdr.control_sz, 1, f))
+        goto _fail1;
+
+    entries = reinterpret_cast<DksaEntry const*>(m_cpuData);
+    control = m_cpuData + tocSize;
+    for (uint32_t i = 0; i < hdr.num_entries; i ++)
+    {
+        auto dksh = reinterpret_cast<DkshHeader const*>(control + entries[i].control_off);
+        if ((entries[i].control_off & (DKSA_ALIGNMENT - 1)) || uint64_t(entries[i].control_off) + sizeof(DkshHeader) > hdr.control_sz ||
+            dksh->magic != DKSH_MAGIC || dksh->control_sz < sizeof(DkshHeader) || (dksh->control_sz & (DKSA_ALIGNMENT - 1)) ||
+            uint64_t(entries[i].control_off) + dksh->control_sz > hdr.control_sz || dksh->num_programs != 1 ||
+            uint64_t(dksh->programs_off) + sizeof(DkshProgramHeader) > dksh->control_sz ||
+            (entries[i].code_off & (DKSA_ALIGNMENT - 1)) || uint64_t(entries[i].code_off) + dksh->code_sz > hdr.code_sz)
+            goto _fail1;
+    }
+
+    // The code sections are already laid out the way they go in the pool, and never read back by the CPU
+    m_mem = pool.allocate(hdr.code_sz, DK_SHADER_CODE_ALIGNMENT);
+    if (!m_mem || !fread(m_mem.getCpuAddr(), hdr.code_sz, 1, f))
+        goto _fail1;
+
+    m_numEntries = hdr.num_entries;
+    fclose(f);
+    return true;
+
+_fail1:
+    destroy();
+_fail0:
+    fclose(f);
+    return false;
+}
+
+int CShaderArchive::findEntry(const char* name) const
+{
+    auto entries = reinterpret_cast<DksaEntry const*>(m_cpuData);
+
+    // The table of contents is sorted by name
+    uint32_t lo = 0, hi = m_numEntries;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        int cmp = strncmp(name, entries[mid].name, DKSA_NAME_LEN);
+        if (cmp == 0)
+            return mid;
+        if (cmp < 0)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return -1;
+}
+
+bool CShaderArchive::initialize(const char* name, dk::Shader& shader) const
+{
+    if (!m_mem)
+        return false;
+
+    int id = findEntry(name);
+    if (id < 0)
+        return false;
+
+    // Headers were validated by load(), which also made sure every entry holds a single program
+    auto entries = reinterpret_cast<DksaEntry const*>(m_cpuData);
+    u8 const* control = m_cpuData + m_numEntries*sizeof(DksaEntry);
+    dk::ShaderMaker{m_mem.getMemBlock(), m_mem.getOffset() + entries[id].code_off}
+        .setControl(control + entries[id].control_off)
+        .setProgramId(0)
+        .initialize(shader);
+    return true;
+}
@@ -0,0 +1,43 @@
+/*
+** Sample Framework for deko3d Applications
+**   CShaderArchive.h: Utility class for loading packed shader archives from the filesystem
+*/
+#pragma once
+#include "common.h"
+#include "CMemPool.h"
+
+struct DksaEntry;
+
+class CShaderArchive
+{
+    CMemPool::Handle m_mem; // Code sections of every packed DKSH
+    u8* m_cpuData; // Table of contents and control sections, in CPU memory
+    uint32_t m_numEntries;
+
+    void destroy();
+    int findEntry(const char* name) const;
+public:
+    CShaderArchive() : m_mem{}, m_cpuData{}, m_numEntries{} { }
+    ~CShaderArchive()
+    {
+        destroy();
+    }
+
+    constexpr operator bool() const
+    {
+        return m_mem;
+    }
+
+    constexpr uint32_t getNumEntries() const
+    {
+        return m_numEntries;
+    }
+
+    // Reads the control sections into CPU memory, where they are parsed, and every code section
+    // into a single allocation in the pool; each with a single read
+    bool load(CMemPool& pool, const char* path);
+
+    // Initializes a shader from the DKSH packed under the given name (its file name without extension).
+    // The shader refers to the archive's code memory, so the archive must outlive it.
+    bool initialize(const char* name, dk::Shader& shader) const;
+};
@@ -0,0 +1,179 @@
+/*
+** Sample Framework for deko3d Applications
+**   CShaderRegistry.cpp: Process-wide cache of shader code, deduplicated by content
+*/
+#include "CShaderRegistry.h"
+#include "CShader.h"
+#include "Dksh.h"
+#include "StreamWrite.h"
+
+static uint64_t hashContents(u8 const* data, uint32_t size)
+{
+    // 64-bit FNV-1a
+    uint64_t h = 14695981039346656037ULL;
+    for (uint32_t i = 0; i < size; i ++)
+    {
+        h ^= data[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+CShaderRegistry& CShaderRegistry::get()
+{
+    static CShaderRegistry s_registry;
+    return s_registry;
+}
+
+CShaderRegistry::~CShaderRegistry()
+{
+    m_paths.iterate([](PathEntry* p) { ::free(p); });
+    m_blobList.iterate([](Blob* b) { ::free(b); });
+}
+
+auto CShaderRegistry::_findBlob(const char* path) -> Blob*
+{
+    for (PathEntry* p = m_paths.first(); p; p = m_paths.next(p))
+        if (strcmp(p->path(), path) == 0)
+            return p->m_blob;
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return nullptr;
+
+    fseek(f, 0, SEEK_END);
+    uint32_t fsize = ftell(f);
+    rewind(f);
+
+    size_t pathLen = strlen(path) + 1;
+    PathEntry* entry = (PathEntry*)::malloc(sizeof(PathEntry) + pathLen);
+    Blob* blob = (Blob*)::malloc(sizeof(Blob) + fsize);
+    if (!entry || !blob || !fsize || !fread(blob->data(), fsize, 1, f) || !CShader::validate(blob->data(), fsize))
+    {
+        ::free(entry);
+        ::free(blob);
+        fclose(f);
+        return nullptr;
+    }
+    fclose(f);
+
+    blob->m_hash = hashContents(blob->data(), fsize);
+    blob->m_size = fsize;
+    blob->m_refCount = 0;
+
+    // Files with identical contents share a single blob
+    Blob* existing = nullptr;
+    for (Blob* other = m_blobs.find(blob->m_hash); other && other->m_hash == blob->m_hash; other = m_blobs.next(other))
+    {
+        if (other->m_size == fsize && memcmp(other->data(), blob->data(), fsize) == 0)
+        {
+            existing = other;
+            break;
+        }
+    }
+
+    if (existing)
+    {
+        ::free(blob);
+        blob = existing;
+    }
+    else
+    {
+        m_blobs.insert(blob, true);
+        m_blobList.add(blob);
+    }
+
+    entry->m_blob = blob;
+    memcpy(entry->path(), path, pathLen);
+    m_paths.add(entry);
+    return blob;
+}
+
+void CShaderRegistry::_freeBlob(Blob* blob)
+{
+    for (PathEntry* p = m_paths.first(); p; )
+    {
+        PathEntry* next = m_paths.next(p);
+        if (p->m_blob == blob)
+        {
+            m_paths.remove(p);
+            ::free(p);
+        }
+        p = next;
+    }
+
+    m_blobs.remove(blob);
+    m_blobList.remove(blob);
+    ::free(blob);
+}
+
+auto CShaderRegistry::acquire(CMemPool& pool, const char* path) -> Code*
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    Blob* blob = _findBlob(path);
+    if (!blob)
+        return nullptr;
+
+    for (Code* code = m_code.first(); code; code = m_code.next(code))
+    {
+        if (code->m_pool == &pool && code->m_blob == blob)
+        {
+            code->m_refCount ++;
+            return code;
+        }
+    }
+
+    // Only the code section goes into the pool, the control section is parsed from the blob
+    auto hdr = reinterpret_cast<DkshHeader const*>(blob->data());
+    Code* code = (Code*)::malloc(sizeof(Code));
+    if (code)
+    {
+        code->m_node = {};
+        code->m_pool = &pool;
+        code->m_blob = blob;
+        code->m_mem = pool.allocate(hdr->code_sz, DK_SHADER_CODE_ALIGNMENT);
+        code->m_refCount = 1;
+        if (!code->m_mem)
+        {
+            ::free(code);
+            code = nullptr;
+        }
+    }
+
+    if (!code)
+        return nullptr;
+
+    StreamCopy(code->m_mem.getCpuAddr(), blob->data() + hdr->control_sz, hdr->code_sz);
+    blob->m_refCount ++;
+    m_code.add(code);
+    return code;
+}
+
+void CShaderRegistry::release(Code* code)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    if (--code->m_refCount)
+        return;
+
+    Blob* blob = code->m_blob;
+    m_code.remove(code);
+    code->m_mem.destroy();
+    ::free(code);
+
+    // The blob stays resident so that loading the file again later reads nothing
+    blob->m_refCount --;
+}
+
+void CShaderRegistry::purge()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    for (Blob* blob = m_blobList.first(); blob; )
+    {
+        Blob* next = m_blobList.next(blob);
+        if (!blob->m_refCount)
+            _freeBlob(blob);
+        blob = next;
+    }
+}
@@ -0,0 +1,87 @@
+/*
+** Sample Framework for deko3d Applications
+**   CShaderRegistry.h: Process-wide cache of shader code, deduplicated by content
+*/
+#pragma once
+#include "common.h"
+#include "CMemPool.h"
+#include "CIntrusiveList.h"
+#include "CIntrusiveTree.h"
+
+#include <mutex>
+
+class CShaderRegistry
+{
+    // File contents, kept in CPU memory until the process exits or purge() is called while no pool uses them
+    struct Blob
+    {
+        CIntrusiveListNode<Blob> m_node;
+        CIntrusiveTreeNode m_treenode;
+        uint64_t m_hash;
+        uint32_t m_size;
+        uint32_t m_refCount; // Number of Code objects using the blob
+
+        u8* data() { return reinterpret_cast<u8*>(this + 1); }
+        u8 const* data() const { return reinterpret_cast<u8 const*>(this + 1); }
+
+        constexpr bool operator<(Blob const& rhs) const { return m_hash < rhs.m_hash; }
+        constexpr bool operator<(uint64_t rhs) const { return m_hash < rhs; }
+    };
+
+    friend constexpr bool operator<(uint64_t lhs, Blob const& rhs);
+
+    struct PathEntry
+    {
+        CIntrusiveListNode<PathEntry> m_node;
+        Blob* m_blob;
+
+        char* path() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+public:
+    // The code section of a blob uploaded to a given pool, shared by every shader using it
+    class Code
+    {
+        friend class CShaderRegistry;
+        CIntrusiveListNode<Code> m_node;
+        CMemPool* m_pool;
+        Blob* m_blob;
+        CMemPool::Handle m_mem;
+        uint32_t m_refCount;
+    public:
+        constexpr CMemPool::Handle const& getMem() const { return m_mem; }
+        // The DKSH header and control section, in CPU memory
+        void const* getControl() const { return m_blob->data(); }
+    };
+
+private:
+    std::mutex m_mutex;
+    CIntrusiveList<Blob, &Blob::m_node> m_blobList;
+    CIntrusiveTree<Blob, &Blob::m_treenode> m_blobs;
+    CIntrusiveList<PathEntry, &PathEntry::m_node> m_paths;
+    CIntrusiveList<Code, &Code::m_node> m_code;
+
+    CShaderRegistry() = default;
+    ~CShaderRegistry();
+
+    Blob* _findBlob(const char* path);
+    void _freeBlob(Blob* blob);
+
+public:
+    static CShaderRegistry& get();
+
+    // Returns the code for the given file resident in the given pool, reading the file only the first time
+    // it is seen by the process, and uploading it only if no identical file is already resident in the pool
+    Code* acquire(CMemPool& pool, const char* path);
+
+    // Drops a reference to the code, freeing its pool memory with the last one; the file contents stay resident
+    void release(Code* code);
+
+    // Frees the contents of every file no pool is using, so they are read again on their next acquire
+    void purge();
+};
+
+constexpr bool operator<(uint64_t lhs, CShaderRegistry::Blob const& rhs)
+{
+    return lhs < rhs.m_hash;
+}
@@ -0,0 +1,249 @@
+/*
+** Sample Framework for deko3d Applications
+**   CStagingRing.cpp: Persistent ring buffer for streaming buffer/image uploads
+*/
+#include "CStagingRing.h"
+
+bool CStagingRing::allocate(dk::Device device, dk::Queue queue, CMemPool& pool, uint32_t size)
+{
+    wait();
+    m_mem.destroy();
+
+    m_mem = pool.allocate(size, DK_MEMBLOCK_ALIGNMENT);
+    if (!m_mem)
+        return false;
+
+    if (!m_cmdmem.allocate(pool, CmdSliceSize))
+    {
+        m_mem.destroy();
+        return false;
+    }
+
+    m_queue = queue;
+    m_cmdbuf = dk::CmdBufMaker{device}.create();
+    m_size = m_mem.getSize();
+    m_head = m_tail = m_lentStart = m_lentEnd = 0;
+    m_firstRetired = m_numRetired = 0;
+    m_numCopies = 0;
+    m_recording = m_lent = false;
+    return true;
+}
+
+void CStagingRing::beginCommands()
+{
+    if (!m_recording)
+    {
+        m_cmdmem.begin(m_cmdbuf);
+        m_recording = true;
+        m_numCopies = 0;
+    }
+}
+
+void CStagingRing::endCommand()
+{
+    // Keep the command list within its command memory slice
+    if (++m_numCopies >= MaxCopiesPerFlush)
+        flush();
+}
+
+void CStagingRing::retireOldest()
+{
+    Retired& r = m_retired[m_firstRetired];
+    r.m_fence.wait();
+    m_tail = r.m_end;
+    m_firstRetired = (m_firstRetired + 1) % MaxInFlight;
+    m_numRetired --;
+}
+
+void CStagingRing::flush()
+{
+    if (!m_recording)
+        return;
+
+    if (m_numRetired == MaxInFlight)
+        retireOldest();
+
+    // Lent space may come after the copies being flushed, and only its borrower's fence can retire it
+    Retired& r = m_retired[(m_firstRetired + m_numRetired) % MaxInFlight];
+    r.m_end = m_lent ? m_lentStart : m_head;
+    m_cmdbuf.signalFence(r.m_fence);
+    m_queue.submitCommands(m_cmdmem.end(m_cmdbuf));
+    m_queue.flush();
+
+    m_numRetired ++;
+    m_recording = false;
+}
+
+void CStagingRing::flush(dk::Fence& fence)
+{
+    // The fence has to be signaled even if an earlier flush already submitted every copy
+    beginCommands();
+    m_cmdbuf.signalFence(fence);
+    flush();
+}
+
+void CStagingRing::wait()
+{
+    flush();
+    while (m_numRetired)
+        retireOldest();
+}
+
+auto CStagingRing::acquire(uint32_t maxSize, uint32_t minSize, uint32_t alignment) -> Span
+{
+    // Skip to the start of the ring if not even minSize bytes fit before its end
+    uint32_t offset = (m_head % m_size + alignment - 1) &~ (alignment - 1);
+    if (offset + minSize > m_size)
+        offset = m_size;
+
+    uint64_t start = m_head - m_head % m_size + offset;
+    if (offset == m_size)
+        offset = 0;
+
+    uint32_t size = m_size - offset < maxSize ? m_size - offset : maxSize;
+
+    // Wait until the GPU has finished with the space we are about to overwrite
+    while (start + size - m_tail > m_size)
+    {
+        if (!m_numRetired)
+        {
+            if (!m_recording && !m_lent)
+            {
+                // Nothing is in flight, so the whole ring is free
+                m_tail = m_head;
+                break;
+            }
+            if (!m_recording)
+                return Span{};
+            flush();
+        }
+        retireOldest();
+    }
+
+    m_head = start + size;
+    return Span{ (u8*)m_mem.getCpuAddr() + offset, m_mem.getGpuAddr() + offset, size, m_head };
+}
+
+auto CStagingRing::acquireSpan(uint32_t size, uint32_t alignment) -> Span
+{
+    if (!m_mem || !size || size > m_size)
+        return Span{};
+    return acquire(size, size, alignment);
+}
+
+auto CStagingRing::readFile(const char* path, uint32_t alignment) -> Span
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return Span{};
+
+    fseek(f, 0, SEEK_END);
+    uint32_t fsize = ftell(f);
+    rewind(f);
+
+    Span span = acquireSpan(fsize, alignment);
+    if (span && fread(span.m_cpuAddr, fsize, 1, f) != 1)
+        span = Span{};
+
+    fclose(f);
+    return span;
+}
+
+void CStagingRing::commitBuffer(Span const& span, DkGpuAddr dst)
+{
+    beginCommands();
+    m_cmdbuf.copyBuffer(span.m_gpuAddr, dst, span.m_size);
+    endCommand();
+}
+
+void CStagingRing::commitImage(Span const& span, dk::ImageView const& view, DkImageRect const& rect, uint32_t rowPitch)
+{
+    beginCommands();
+    m_cmdbuf.copyBufferToImage({ span.m_gpuAddr, rowPitch, 0 }, view, rect);
+    endCommand();
+}
+
+void CStagingRing::lendSpan(Span const& span)
+{
+    if (!m_lent)
+    {
+        m_lentStart = span.m_end - span.m_size;
+        m_lent = true;
+    }
+    m_lentEnd = span.m_end;
+}
+
+void CStagingRing::returnSpans(dk::Fence const* fence)
+{
+    if (!m_lent)
+        return;
+
+    // Spans of commands that were never submitted are free straight away
+    if (fence)
+    {
+        if (m_numRetired == MaxInFlight)
+            retireOldest();
+
+        Retired& r = m_retired[(m_firstRetired + m_numRetired) % MaxInFlight];
+        r.m_fence = *fence;
+        r.m_end = m_lentEnd;
+        m_numRetired ++;
+    }
+    m_lent = false;
+}
+
+bool CStagingRing::uploadBuffer(DkGpuAddr dst, void const* data, uint32_t size)
+{
+    if (!m_mem)
+        return false;
+
+    auto src = static_cast<u8 const*>(data);
+    while (size)
+    {
+        Span span = acquire(size, 1, DK_CMDMEM_ALIGNMENT);
+        if (!span)
+            return false;
+        memcpy(span.m_cpuAddr, src, span.m_size);
+
+        beginCommands();
+        m_cmdbuf.copyBuffer(span.m_gpuAddr, dst, span.m_size);
+        endCommand();
+
+        src += span.m_size;
+        dst += span.m_size;
+        size -= span.m_size;
+    }
+    return true;
+}
+
+bool CStagingRing::uploadImage(dk::ImageView const& view, DkImageRect const& rect, void const* data, uint32_t rowPitch, uint32_t blockHeight)
+{
+    if (!m_mem || !rowPitch || rowPitch > m_size)
+        return false;
+
+    // Slices are uploaded one at a time, so that every copy reads rows from a single slice
+    auto src = static_cast<u8 const*>(data);
+    uint32_t numRows = (rect.height + blockHeight - 1) / blockHeight;
+    for (uint32_t z = 0; z < rect.depth; z ++)
+    {
+        uint32_t row = 0;
+        while (row < numRows)
+        {
+            Span span = acquire((numRows - row) * rowPitch, rowPitch, DK_IMAGE_LINEAR_STRIDE_ALIGNMENT);
+            if (!span)
+                return false;
+            uint32_t rows = span.m_size / rowPitch;
+            memcpy(span.m_cpuAddr, src, rows * rowPitch);
+
+            uint32_t y = row * blockHeight;
+            uint32_t height = rows * blockHeight < rect.height - y ? rows * blockHeight : rect.height - y;
+
+            beginCommands();
+            m_cmdbuf.copyBufferToImage({ span.m_gpuAddr, rowPitch, 0 }, view, { rect.x, rect.y + y, rect.z + z, rect.width, height, 1 });
+            endCommand();
+
+            src += rows * rowPitch;
+            row += rows;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,120 @@
+/*
+** Sample Framework for deko3d Applications
+**   CStagingRing.h: Persistent ring buffer for streaming buffer/image uploads
+*/
+#pragma once
+#include "common.h"
+#include "CMemPool.h"
+#include "CCmdMemRing.h"
+
+class CStagingRing
+{
+    // Every flush submits one command list and retires the ring space it used with one fence
+    static constexpr unsigned MaxInFlight = 8;
+    static constexpr unsigned MaxCopiesPerFlush = 16;
+    static constexpr uint32_t CmdSliceSize = DK_MEMBLOCK_ALIGNMENT;
+
+    struct Retired
+    {
+        dk::Fence m_fence;
+        uint64_t m_end; // Ring position up to which space is freed once the fence is signaled
+    };
+
+    dk::Queue m_queue;
+    dk::UniqueCmdBuf m_cmdbuf;
+    CCmdMemRing<MaxInFlight> m_cmdmem;
+    CMemPool::Handle m_mem;
+    uint32_t m_size;
+
+    // Positions increase monotonically and are reduced modulo m_size to get ring offsets
+    uint64_t m_head;      // Next byte to hand out
+    uint64_t m_tail;      // Oldest byte that may still be read by the GPU
+    uint64_t m_lentStart; // Space lent out by lendSpan, which only returnSpans can retire
+    uint64_t m_lentEnd;
+
+    Retired m_retired[MaxInFlight];
+    unsigned m_firstRetired;
+    unsigned m_numRetired;
+    unsigned m_numCopies;
+    bool m_recording;
+    bool m_lent;
+
+public:
+    // Ring memory handed out to be filled in place; m_end is the ring position it ends at
+    struct Span
+    {
+        void* m_cpuAddr;
+        DkGpuAddr m_gpuAddr;
+        uint32_t m_size;
+        uint64_t m_end;
+
+        constexpr operator bool() const
+        {
+            return m_cpuAddr;
+        }
+    };
+
+private:
+    void beginCommands();
+    void endCommand();
+    void retireOldest();
+    Span acquire(uint32_t maxSize, uint32_t minSize, uint32_t alignment);
+
+public:
+    CStagingRing() : m_queue{}, m_cmdbuf{}, m_cmdmem{}, m_mem{}, m_size{}, m_head{}, m_tail{}, m_lentStart{}, m_lentEnd{},
+        m_retired{}, m_firstRetired{}, m_numRetired{}, m_numCopies{}, m_recording{}, m_lent{} { }
+    ~CStagingRing()
+    {
+        wait();
+        m_cmdbuf.destroy();
+        m_mem.destroy();
+    }
+
+    CStagingRing(CStagingRing const&) = delete;
+    CStagingRing& operator=(CStagingRing const&) = delete;
+
+    // The pool must be CPU and GPU accessible; command memory comes from it too
+    bool allocate(dk::Device device, dk::Queue queue, CMemPool& pool, uint32_t size);
+
+    constexpr uint32_t getSize() const
+    {
+        return m_size;
+    }
+
+    // Copies data into the ring and records GPU copies to the destination, splitting the upload into
+    // several pieces when it doesn't fit before the end of the ring or in the ring at all
+    bool uploadBuffer(DkGpuAddr dst, void const* data, uint32_t size);
+
+    // Same for images: data holds rows of rowPitch bytes, each covering blockHeight rows of pixels
+    // (e.g. 4 for BCn formats), with the rows of each of the rect.depth slices following the previous ones.
+    // Pieces always contain whole rows of a single slice.
+    bool uploadImage(dk::ImageView const& view, DkImageRect const& rect, void const* data, uint32_t rowPitch, uint32_t blockHeight = 1);
+
+    // Hands out size contiguous bytes to be filled in place, waiting for older uploads to free them if needed.
+    // Returns an empty span if size doesn't fit in the ring, or if only returnSpans could free enough space.
+    // A span that ends up unused needs no cleanup; its space is reused once the uploads before it are done.
+    Span acquireSpan(uint32_t size, uint32_t alignment = DK_IMAGE_LINEAR_STRIDE_ALIGNMENT);
+
+    // Reads a whole file straight into a span, like LoadFile does into a pool allocation
+    Span readFile(const char* path, uint32_t alignment = DK_IMAGE_LINEAR_STRIDE_ALIGNMENT);
+
+    // Record the copy out of a filled span; its space is retired by the fence of the flush that submits it.
+    // A rowPitch of 0 means tightly packed rows.
+    void commitBuffer(Span const& span, DkGpuAddr dst);
+    void commitImage(Span const& span, dk::ImageView const& view, DkImageRect const& rect, uint32_t rowPitch = 0);
+
+    // For spans read by commands submitted elsewhere, e.g. by a CUploadBatch: their space is kept until
+    // returnSpans is given the fence those commands signal, or nullptr if they were never submitted.
+    // Only one borrower may hold lent spans at a time.
+    void lendSpan(Span const& span);
+    void returnSpans(dk::Fence const* fence);
+
+    // Submits the copies recorded so far
+    void flush();
+
+    // Same, also signaling fence (e.g. an upload ticket's) once they have completed
+    void flush(dk::Fence& fence);
+
+    // Submits and waits until every upload has completed
+    void wait();
+};
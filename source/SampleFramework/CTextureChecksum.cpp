@@ -0,0 +1,79 @@
+/*
+** Sample Framework for deko3d Applications
+**   CTextureChecksum.cpp: Draws textures offscreen and checksums what the GPU rendered
+*/
+#include "CTextureChecksum.h"
+
+bool CTextureChecksum::allocate(dk::Device device, CMemPool& imagePool, CMemPool& dataPool, CMemPool& codePool, CMemPool& readbackPool,
+    uint32_t width, uint32_t height)
+{
+    dk::ImageLayout layout;
+    dk::ImageLayoutMaker{device}
+        .setFlags(DkImageFlags_UsageRender | DkImageFlags_HwCompression)
+        .setFormat(DkImageFormat_RGBA8_Unorm)
+        .setDimensions(width, height)
+        .initialize(layout);
+
+    m_cmdmem = dataPool.allocate(CmdSize);
+    m_targetMem = imagePool.allocate(layout.getSize(), layout.getAlignment());
+    if (!m_cmdmem || !m_targetMem)
+        return false;
+
+    if (!m_readback.allocate(readbackPool, device, width, height, DkImageFormat_RGBA8_Unorm, 4) ||
+        !m_imageDescriptorSet.allocate(dataPool) || !m_samplerDescriptorSet.allocate(dataPool))
+        return false;
+
+    if (!m_vertexShader.loadShared(codePool, "romfs:/shaders/full_tri_vsh.dksh") ||
+        !m_fragmentShader.loadShared(codePool, "romfs:/shaders/sample_fsh.dksh"))
+        return false;
+
+    m_cmdbuf = dk::CmdBufMaker{device}.create();
+    m_target.initialize(layout, m_targetMem.getMemBlock(), m_targetMem.getOffset());
+    m_width = width;
+    m_height = height;
+
+    dk::Sampler sampler;
+    sampler.setFilter(DkFilter_Linear, DkFilter_Linear);
+    sampler.setWrapMode(DkWrapMode_ClampToEdge, DkWrapMode_ClampToEdge, DkWrapMode_ClampToEdge);
+    m_samplerDescriptor.initialize(sampler);
+    return true;
+}
+
+uint32_t CTextureChecksum::draw(dk::Queue queue, dk::ImageDescriptor const& texture)
+{
+    if (!m_readback)
+        return 0;
+
+    dk::RasterizerState rasterizerState;
+    dk::ColorState colorState;
+    dk::ColorWriteState colorWriteState;
+    dk::DepthStencilState depthStencilState;
+    dk::ImageView colorTarget{ m_target };
+
+    m_cmdbuf.clear();
+    m_cmdbuf.addMemory(m_cmdmem.getMemBlock(), m_cmdmem.getOffset(), m_cmdmem.getSize());
+
+    m_imageDescriptorSet.update(m_cmdbuf, 0, texture);
+    m_samplerDescriptorSet.update(m_cmdbuf, 0, m_samplerDescriptor);
+    m_imageDescriptorSet.bindForImages(m_cmdbuf);
+    m_samplerDescriptorSet.bindForSamplers(m_cmdbuf);
+
+    m_cmdbuf.bindRenderTargets(&colorTarget);
+    m_cmdbuf.setViewports(0, { { 0.0f, 0.0f, float(m_width), float(m_height) } });
+    m_cmdbuf.setScissors(0, { { 0, 0, m_width, m_height } });
+    m_cmdbuf.clearColor(0, DkColorMask_RGBA, 0.0f, 0.25f, 0.0f, 1.0f);
+    m_cmdbuf.bindShaders(DkStageFlag_GraphicsMask, { m_vertexShader, m_fragmentShader });
+    m_cmdbuf.bindRasterizerState(rasterizerState);
+    m_cmdbuf.bindColorState(colorState);
+    m_cmdbuf.bindColorWriteState(colorWriteState);
+    m_cmdbuf.bindDepthStencilState(depthStencilState);
+    m_cmdbuf.bindTextures(DkStage_Fragment, 0, dkMakeTextureHandle(0, 0));
+    m_cmdbuf.draw(DkPrimitive_Triangles, 3, 1, 0, 0);
+
+    m_cmdbuf.barrier(DkBarrier_Fragments, 0);
+    m_readback.capture(m_cmdbuf, colorTarget);
+
+    queue.submitCommands(m_cmdbuf.finishList());
+    queue.waitIdle();
+    return m_readback.checksum();
+}
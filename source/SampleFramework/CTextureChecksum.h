@@ -0,0 +1,51 @@
+/*
+** Sample Framework for deko3d Applications
+**   CTextureChecksum.h: Draws textures offscreen and checksums what the GPU rendered
+*/
+#pragma once
+#include "common.h"
+#include "CMemPool.h"
+#include "CDescriptorSet.h"
+#include "CImageReadback.h"
+#include "CShader.h"
+
+class CTextureChecksum
+{
+    static constexpr uint32_t CmdSize = 0x1000;
+
+    dk::UniqueCmdBuf m_cmdbuf;
+    CMemPool::Handle m_cmdmem;
+    CMemPool::Handle m_targetMem;
+    dk::Image m_target;
+    uint32_t m_width;
+    uint32_t m_height;
+    CImageReadback m_readback;
+
+    CShader m_vertexShader;
+    CShader m_fragmentShader;
+    CDescriptorSet<1> m_imageDescriptorSet;
+    CDescriptorSet<1> m_samplerDescriptorSet;
+    dk::SamplerDescriptor m_samplerDescriptor;
+
+public:
+    CTextureChecksum() : m_cmdbuf{}, m_cmdmem{}, m_targetMem{}, m_target{}, m_width{}, m_height{}, m_readback{},
+        m_vertexShader{}, m_fragmentShader{}, m_imageDescriptorSet{}, m_samplerDescriptorSet{}, m_samplerDescriptor{} { }
+    ~CTextureChecksum()
+    {
+        m_cmdbuf.destroy();
+        m_cmdmem.destroy();
+        m_targetMem.destroy();
+    }
+
+    CTextureChecksum(CTextureChecksum const&) = delete;
+    CTextureChecksum& operator=(CTextureChecksum const&) = delete;
+
+    // The render target comes from imagePool, command memory and descriptors from dataPool (CPU accessible),
+    // and the readback image from readbackPool (see CImageReadback::allocate)
+    bool allocate(dk::Device device, CMemPool& imagePool, CMemPool& dataPool, CMemPool& codePool, CMemPool& readbackPool,
+        uint32_t width, uint32_t height);
+
+    // Draws the texture over the whole target, waits for the queue to be idle and returns the checksum
+    // of the rendered pixels, so that textures loaded different ways can be compared
+    uint32_t draw(dk::Queue queue, dk::ImageDescriptor const& texture);
+};
@@ -0,0 +1,116 @@
+/*
+** Sample Framework for deko3d Applications
+**   CUploadBatch.cpp: Batches buffer/image uploads into a single submission
+*/
+#include "CUploadBatch.h"
+
+bool CUploadBatch::allocate(dk::Device device, CMemPool& scratchPool, uint32_t cmdSize)
+{
+    wait();
+    m_cmdmem.destroy();
+
+    m_cmdmem = scratchPool.allocate(cmdSize);
+    if (!m_cmdmem)
+        return false;
+
+    m_cmdbuf = dk::CmdBufMaker{device}.create();
+    uint32_t numSlots = m_cmdmem.getSize() / MaxCopyCmdSize;
+    m_maxCopies = numSlots > 1 ? numSlots - 1 : 0;
+    reset();
+    return true;
+}
+
+void CUploadBatch::release()
+{
+    for (auto& mem : m_staging)
+        mem.destroy();
+    m_staging.clear();
+
+    // Borrowed spans are only still held here if their copies were never submitted
+    if (m_ring)
+    {
+        m_ring->returnSpans(nullptr);
+        m_ring = nullptr;
+    }
+}
+
+void CUploadBatch::reset()
+{
+    release();
+    m_cmdbuf.clear();
+    m_cmdbuf.addMemory(m_cmdmem.getMemBlock(), m_cmdmem.getOffset(), m_cmdmem.getSize());
+    m_numCopies = 0;
+    m_submitted = false;
+}
+
+bool CUploadBatch::copyBuffer(CMemPool::Handle staging, DkGpuAddr dst, uint32_t size)
+{
+    if (isFull())
+        return false;
+
+    m_cmdbuf.copyBuffer(staging.getGpuAddr(), dst, size);
+    m_staging.push_back(staging);
+    m_numCopies ++;
+    return true;
+}
+
+bool CUploadBatch::copyBufferToImage(CMemPool::Handle staging, dk::ImageView const& view, DkImageRect const& rect)
+{
+    if (isFull())
+        return false;
+
+    m_cmdbuf.copyBufferToImage({ staging.getGpuAddr() }, view, rect);
+    m_staging.push_back(staging);
+    m_numCopies ++;
+    return true;
+}
+
+bool CUploadBatch::copyBufferToImage(CStagingRing& ring, CStagingRing::Span const& span, dk::ImageView const& view, DkImageRect const& rect)
+{
+    if (isFull() || (m_ring && m_ring != &ring))
+        return false;
+
+    m_cmdbuf.copyBufferToImage({ span.m_gpuAddr }, view, rect);
+    ring.lendSpan(span);
+    m_ring = &ring;
+    m_numCopies ++;
+    return true;
+}
+
+void CUploadBatch::submit(dk::Queue queue)
+{
+    if (m_submitted || !m_numCopies)
+        return;
+
+    m_cmdbuf.signalFence(m_fence);
+    queue.submitCommands(m_cmdbuf.finishList());
+    queue.flush();
+    m_submitted = true;
+
+    if (m_ring)
+    {
+        m_ring->returnSpans(&m_fence);
+        m_ring = nullptr;
+    }
+}
+
+bool CUploadBatch::isDone()
+{
+    if (!m_submitted)
+        return !m_numCopies;
+
+    if (m_fence.wait(0) != DkResult_Success)
+        return false;
+
+    reset();
+    return true;
+}
+
+void CUploadBatch::wait()
+{
+    if (!m_submitted)
+        return;
+
+    m_fence.wait();
+    reset();
+}
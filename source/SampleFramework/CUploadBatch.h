@@ -0,0 +1,73 @@
+/*
+** Sample Framework for deko3d Applications
+**   CUploadBatch.h: Batches buffer/image uploads into a single submission
+*/
+#pragma once
+#include "common.h"
+#include "CMemPool.h"
+#include "CStagingRing.h"
+
+#include <vector>
+
+class CUploadBatch
+{
+    dk::UniqueCmdBuf m_cmdbuf;
+    CMemPool::Handle m_cmdmem;
+    dk::Fence m_fence;
+    std::vector<CMemPool::Handle> m_staging;
+    CStagingRing* m_ring; // Ring whose spans the batch has borrowed, if any
+    uint32_t m_numCopies;
+    uint32_t m_maxCopies;
+    bool m_submitted;
+
+    void release();
+    void reset();
+public:
+    // Each recorded copy takes roughly a hundred bytes of command memory; this is a safe upper bound,
+    // and the same amount is kept aside for the fence signaled by submit()
+    static constexpr uint32_t MaxCopyCmdSize = 0x100;
+    static constexpr uint32_t DefaultCmdSize = 4*DK_MEMBLOCK_ALIGNMENT;
+
+    CUploadBatch() : m_cmdbuf{}, m_cmdmem{}, m_fence{}, m_staging{}, m_ring{}, m_numCopies{}, m_maxCopies{}, m_submitted{} { }
+    ~CUploadBatch()
+    {
+        wait();
+        release();
+        m_cmdbuf.destroy();
+        m_cmdmem.destroy();
+    }
+
+    CUploadBatch(CUploadBatch const&) = delete;
+    CUploadBatch& operator=(CUploadBatch const&) = delete;
+
+    bool allocate(dk::Device device, CMemPool& scratchPool, uint32_t cmdSize = DefaultCmdSize);
+
+    uint32_t getNumStaged() const
+    {
+        return m_staging.size();
+    }
+
+    // Whether the command memory has room for another copy; once full, submit and wait before recording more
+    bool isFull() const
+    {
+        return m_submitted || m_numCopies >= m_maxCopies;
+    }
+
+    // Record a copy out of a staging slice, which the batch takes ownership of and frees after completion.
+    // Return false without recording anything or taking ownership when the batch is full.
+    bool copyBuffer(CMemPool::Handle staging, DkGpuAddr dst, uint32_t size);
+    bool copyBufferToImage(CMemPool::Handle staging, dk::ImageView const& view, DkImageRect const& rect);
+
+    // Same out of a span of ring, which the batch borrows and gives back with its fence on submission.
+    // All spans of a batch must come from the same ring.
+    bool copyBufferToImage(CStagingRing& ring, CStagingRing::Span const& span, dk::ImageView const& view, DkImageRect const& rect);
+
+    // Submits everything recorded so far as one command list followed by one fence
+    void submit(dk::Queue queue);
+
+    // Polls the fence, releasing the staging memory and readying the batch for reuse once it has signaled
+    bool isDone();
+
+    // Blocks until the submitted uploads are complete, then does the same
+    void wait();
+};
@@ -0,0 +1,42 @@
+/*
+** Sample Framework for deko3d Applications
+**   CUploadTicket.h: Completion handle for an upload in flight on the GPU
+*/
+#pragma once
+#include "common.h"
+
+class CUploadTicket
+{
+    dk::Fence m_fence;
+    bool m_pending;
+public:
+    CUploadTicket() : m_fence{}, m_pending{} { }
+
+    // Returns the fence the upload must signal on completion, marking the ticket as pending
+    dk::Fence& arm()
+    {
+        m_pending = true;
+        return m_fence;
+    }
+
+    constexpr dk::Fence const& getFence() const
+    {
+        return m_fence;
+    }
+
+    bool isReady()
+    {
+        if (m_pending && m_fence.wait(0) == DkResult_Success)
+            m_pending = false;
+        return !m_pending;
+    }
+
+    void wait()
+    {
+        if (m_pending)
+        {
+            m_fence.wait();
+            m_pending = false;
+        }
+    }
+};
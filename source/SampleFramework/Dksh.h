@@ -0,0 +1,73 @@
+/*
+** Sample Framework for deko3d Applications
+**   Dksh.h: DKSH shader file and shader archive format definitions
+*/
+#pragma once
+#include <stdint.h>
+
+// This header is deliberately self-contained so that host tools can use it too
+
+constexpr uint32_t DKSH_MAGIC = 0x48534B44; // 'DKSH'
+
+struct DkshHeader
+{
+    uint32_t magic; // DKSH_MAGIC
+    uint32_t header_sz; // sizeof(DkshHeader)
+    uint32_t control_sz;
+    uint32_t code_sz;
+    uint32_t programs_off;
+    uint32_t num_programs;
+};
+
+enum DkshProgramType
+{
+    DkshProgramType_Vertex   = 0,
+    DkshProgramType_Fragment = 1,
+    DkshProgramType_Geometry = 2,
+    DkshProgramType_TessCtrl = 3,
+    DkshProgramType_TessEval = 4,
+    DkshProgramType_Compute  = 5,
+};
+
+// Only the common fields are described here, the rest is stage-specific data meant for deko3d
+struct DkshProgramHeader
+{
+    uint32_t type; // DkshProgramType
+    uint32_t entrypoint;
+    uint32_t num_gprs;
+    uint32_t constbuf1_off;
+    uint32_t constbuf1_sz;
+    uint32_t per_warp_scratch_sz;
+    uint32_t stage_data[10];
+};
+
+static_assert(sizeof(DkshProgramHeader) == 64, "Bad DkshProgramHeader size");
+
+// Shader archives pack several DKSH files behind a table of contents sorted by name. The control
+// sections of every DKSH follow the table, and all of their code sections come last, each padded to
+// the shader code alignment: a loader reads the control sections into CPU memory with one read, and
+// the code sections into a single code memory allocation with another.
+// Every packed DKSH holds exactly one program.
+
+constexpr uint32_t DKSA_MAGIC = 0x41534B44; // 'DKSA'
+constexpr uint32_t DKSA_ALIGNMENT = 0x100; // DK_SHADER_CODE_ALIGNMENT
+constexpr uint32_t DKSA_NAME_LEN = 56;
+
+struct DksaHeader
+{
+    uint32_t magic; // DKSA_MAGIC
+    uint32_t header_sz; // sizeof(DksaHeader)
+    uint32_t num_entries;
+    uint32_t control_sz; // Size of the control sections, which follow the table of contents
+    uint32_t code_sz; // Size of the code sections, which follow the control sections
+};
+
+struct DksaEntry
+{
+    char name[DKSA_NAME_LEN]; // NUL-terminated file name without the .dksh extension
+    uint32_t control_off; // Relative to the first control section, aligned to DKSA_ALIGNMENT
+    uint32_t code_off; // Relative to the first code section, aligned to DKSA_ALIGNMENT
+};
+
+static_assert(sizeof(DksaHeader) == 20, "Bad DksaHeader size");
+static_assert(sizeof(DksaEntry) == 64, "Bad DksaEntry size");
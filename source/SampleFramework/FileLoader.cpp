@@ -3,6 +3,15 @@
 **   FileLoader.cpp: Helpers for loading data from the filesystem directly into GPU memory
 */
 #include "FileLoader.h"
+#include "CCmdMemRing.h"
+#include "Lz4.h"
+
+#ifndef __SWITCH__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 CMemPool::Handle LoadFile(CMemPool& pool, const char* path, uint32_t alignment)
 {
@@ -25,3 +34,126 @@ CMemPool::Handle LoadFile(CMemPool& pool, const char* path, uint32_t alignment)
 
     return mem;
 }
+
+CMemPool::Handle LoadFileCompressed(CMemPool& pool, const char* path, uint32_t alignment)
+{
+    DklzHeader hdr;
+    CMemPool::Handle mem;
+    u8* data;
+
+    FILE *f = fopen(path, "rb");
+    if (!f) return nullptr;
+
+    fseek(f, 0, SEEK_END);
+    uint32_t fsize = ftell(f);
+    rewind(f);
+
+    if (!fread(&hdr, sizeof(hdr), 1, f))
+        goto _fail0;
+
+    if (hdr.magic != DKLZ_MAGIC || hdr.header_sz != sizeof(DklzHeader) || !hdr.size ||
+        hdr.compressed_sz != fsize - sizeof(DklzHeader))
+        goto _fail0;
+
+    mem = pool.allocate(hdr.size + DKLZ_INPLACE_MARGIN(hdr.compressed_sz), alignment);
+    if (!mem)
+        goto _fail0;
+
+    // Place the compressed block at the very end so that the decompressor never catches up with it
+    data = (u8*)mem.getCpuAddr();
+    if (!fread(data + mem.getSize() - hdr.compressed_sz, hdr.compressed_sz, 1, f))
+        goto _fail1;
+
+    if (!Lz4Decompress(data + mem.getSize() - hdr.compressed_sz, hdr.compressed_sz, data, hdr.size))
+        goto _fail1;
+
+    fclose(f);
+    return mem;
+
+_fail1:
+    mem.destroy();
+_fail0:
+    fclose(f);
+    return nullptr;
+}
+
+CMemPool::Handle LoadFileStreamed(CMemPool& pool, CMemPool& scratchPool, dk::Device device, dk::Queue queue, const char* path, uint32_t alignment, uint32_t chunkSize)
+{
+    CMemPool::Handle mem;
+    dk::UniqueCmdBuf cmdbuf = dk::CmdBufMaker{device}.create();
+    CCmdMemRing<2> cmdmem;
+    if (!cmdmem.allocate(scratchPool, DK_MEMBLOCK_ALIGNMENT))
+        return nullptr;
+
+    bool ok = StreamFile(scratchPool, path, chunkSize, [&](FileChunk& chunk)
+    {
+        if (!mem)
+        {
+            mem = pool.allocate(chunk.fileSize, alignment);
+            if (!mem)
+                return false;
+        }
+
+        // The copy of this chunk runs while the next one is being read into the other buffer
+        cmdmem.begin(cmdbuf);
+        cmdbuf.copyBuffer(chunk.gpuAddr, mem.getGpuAddr() + chunk.offset, chunk.size);
+        cmdbuf.signalFence(chunk.ticket.arm());
+        queue.submitCommands(cmdmem.end(cmdbuf));
+        queue.flush();
+        return true;
+    });
+
+    // StreamFile has waited for the copies, but the command memory must be idle before it is freed too
+    queue.waitIdle();
+    if (!ok)
+        mem.destroy();
+
+    return mem;
+}
+
+#ifndef __SWITCH__
+
+static void UnmapFile(void* storage, uint32_t size)
+{
+    munmap(storage, size);
+}
+
+CMemPool::Handle LoadFileMapped(CMemPool& pool, const char* path, uint32_t alignment)
+{
+    if (alignment > DK_MEMBLOCK_ALIGNMENT || (size_t)sysconf(_SC_PAGESIZE) > DK_MEMBLOCK_ALIGNMENT)
+        return LoadFile(pool, path, alignment);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || !st.st_size)
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    // Only the mapping is rounded up to the memory block alignment, the handle covers exactly the file
+    // like LoadFile's would. The mapping is private, so writes through the handle never reach the file.
+    uint32_t mapSize = (st.st_size + DK_MEMBLOCK_ALIGNMENT - 1) &~ (DK_MEMBLOCK_ALIGNMENT - 1);
+    void* storage = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (storage == MAP_FAILED)
+        return nullptr;
+
+    CMemPool::Handle mem = pool.import(storage, mapSize, UnmapFile, st.st_size);
+    if (!mem)
+        munmap(storage, mapSize);
+
+    return mem;
+}
+
+#else
+
+CMemPool::Handle LoadFileMapped(CMemPool& pool, const char* path, uint32_t alignment)
+{
+    // romfs can't be memory mapped, so this always has to copy
+    return LoadFile(pool, path, alignment);
+}
+
+#endif
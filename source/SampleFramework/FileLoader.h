@@ -5,5 +5,88 @@
 #pragma once
 #include "common.h"
 #include "CMemPool.h"
+#include "CUploadTicket.h"
 
 CMemPool::Handle LoadFile(CMemPool& pool, const char* path, uint32_t alignment = DK_CMDMEM_ALIGNMENT);
+
+// Maps the file straight into a dedicated memory block instead of copying it, where the platform
+// allows it (host builds). Falls back to LoadFile otherwise, or if alignment exceeds the page size.
+CMemPool::Handle LoadFileMapped(CMemPool& pool, const char* path, uint32_t alignment = DK_CMDMEM_ALIGNMENT);
+
+// Loads an LZ4-compressed asset (see Lz4.h), decompressing it in place inside the destination slice.
+// The compressed data is read into the tail of the slice and nothing else is allocated, but note that
+// on CPU-uncached pools the decompressor then reads both its input and match data from uncached memory.
+CMemPool::Handle LoadFileCompressed(CMemPool& pool, const char* path, uint32_t alignment = DK_CMDMEM_ALIGNMENT);
+
+// Streams the file through a double-buffered staging area in scratchPool and copies it chunk by chunk
+// on the GPU into an allocation from pool, which therefore doesn't need to be CPU accessible.
+CMemPool::Handle LoadFileStreamed(CMemPool& pool, CMemPool& scratchPool, dk::Device device, dk::Queue queue,
+    const char* path, uint32_t alignment = DK_CMDMEM_ALIGNMENT, uint32_t chunkSize = 0x10000);
+
+struct FileChunk
+{
+    void* cpuAddr;
+    DkGpuAddr gpuAddr;
+    uint32_t offset;       // Position of the chunk within the file
+    uint32_t size;
+    uint32_t fileSize;
+    unsigned slot;         // Which of the two staging buffers holds the chunk
+    CUploadTicket& ticket; // Signal ticket.arm() if the chunk is still being read after the consumer returns
+};
+
+// Reads a file in chunks of at most chunkSize bytes, alternating between two staging buffers allocated
+// from stagingPool, and calls consumer(FileChunk&) for each one. A buffer is only refilled once the
+// ticket of the chunk it last held is ready, so the consumer can hand a chunk to the GPU and have
+// the next one read in the meantime. Tickets that were never armed are not waited on. Peak memory use is two chunks regardless of the file size.
+template <typename Consumer>
+bool StreamFile(CMemPool& stagingPool, const char* path, uint32_t chunkSize, Consumer&& consumer)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+
+    fseek(f, 0, SEEK_END);
+    uint32_t fsize = ftell(f);
+    rewind(f);
+
+    if (!fsize || !chunkSize)
+    {
+        fclose(f);
+        return false;
+    }
+
+    chunkSize = chunkSize < fsize ? chunkSize : fsize;
+    uint32_t stride = (chunkSize + DK_IMAGE_LINEAR_STRIDE_ALIGNMENT - 1) &~ (DK_IMAGE_LINEAR_STRIDE_ALIGNMENT - 1);
+    CMemPool::Handle staging = stagingPool.allocate(2*stride, DK_IMAGE_LINEAR_STRIDE_ALIGNMENT);
+    if (!staging)
+    {
+        fclose(f);
+        return false;
+    }
+
+    CUploadTicket tickets[2];
+    bool ok = true;
+    for (uint32_t offset = 0, slot = 0; ok && offset < fsize; offset += chunkSize, slot ^= 1)
+    {
+        // Wait for the consumer to be done with what this buffer held last time
+        tickets[slot].wait();
+
+        FileChunk chunk =
+        {
+            (u8*)staging.getCpuAddr() + slot*stride,
+            staging.getGpuAddr() + slot*stride,
+            offset,
+            fsize - offset < chunkSize ? fsize - offset : chunkSize,
+            fsize,
+            slot,
+            tickets[slot],
+        };
+
+        ok = fread(chunk.cpuAddr, chunk.size, 1, f) == 1 && consumer(chunk);
+    }
+
+    fclose(f);
+    tickets[0].wait();
+    tickets[1].wait();
+    staging.destroy();
+    return ok;
+}
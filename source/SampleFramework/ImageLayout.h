@@ -0,0 +1,193 @@
+/*
+** Sample Framework for deko3d Applications
+**   ImageLayout.h: CPU-side calculation of image memory layouts, matching dk::ImageLayout
+*/
+#pragma once
+#include "Swizzle.h"
+
+// This header is deliberately self-contained so that host tools can use it too
+
+constexpr uint32_t IMAGE_LINEAR_STRIDE_ALIGNMENT = 32; // DK_IMAGE_LINEAR_STRIDE_ALIGNMENT
+constexpr int32_t IMAGE_AUTO_TILE_SIZE = -1;
+
+// Corresponds to DkImageType, minus the multisampled and rectangle types
+enum ImageLayoutType
+{
+    ImageLayoutType_1D,
+    ImageLayoutType_2D,
+    ImageLayoutType_3D,
+    ImageLayoutType_1DArray,
+    ImageLayoutType_2DArray,
+    ImageLayoutType_Cubemap,
+    ImageLayoutType_CubemapArray,
+    ImageLayoutType_Buffer,
+};
+
+// Storage of a format: bytes per compression block and the block's size in pixels (1x1 if uncompressed)
+struct ImageFormatInfo
+{
+    uint32_t bytesPerBlock;
+    uint32_t blockWidth = 1;
+    uint32_t blockHeight = 1;
+};
+
+constexpr ImageFormatInfo ImageFormatInfo_R8     = { 1 };
+constexpr ImageFormatInfo ImageFormatInfo_RG8    = { 2 };
+constexpr ImageFormatInfo ImageFormatInfo_RGBA8  = { 4 };
+constexpr ImageFormatInfo ImageFormatInfo_RGBA16 = { 8 };
+constexpr ImageFormatInfo ImageFormatInfo_RGBA32 = { 16 };
+constexpr ImageFormatInfo ImageFormatInfo_BC1    = { 8, 4, 4 }; // Also BC4 and ETC2 without alpha
+constexpr ImageFormatInfo ImageFormatInfo_BC3    = { 16, 4, 4 }; // Also BC2, BC5, BC6H, BC7 and ETC2 with alpha
+
+constexpr ImageFormatInfo ImageFormatInfo_ASTC(uint32_t blockWidth, uint32_t blockHeight)
+{
+    return { 16, blockWidth, blockHeight };
+}
+
+// What goes into dk::ImageLayoutMaker. depth is the number of slices of 3D images and the number of
+// layers of array images, with 6 layers per cubemap (so 6 for a plain cubemap).
+struct ImageLayoutParams
+{
+    ImageLayoutType type;
+    ImageFormatInfo format;
+    uint32_t width;
+    uint32_t height = 1;
+    uint32_t depth = 1;
+    uint32_t mipLevels = 1;
+    int32_t tileSize = IMAGE_AUTO_TILE_SIZE; // DkTileSize, as given with DkImageFlags_CustomTileSize
+    uint32_t pitchStride = 0; // Non-zero for DkImageFlags_PitchLinear
+};
+
+// The layout of an image in memory, enough to write any subresource of it from the CPU.
+// Sizes and offsets don't account for the extra padding deko3d may add for DkImageFlags_HwCompression.
+struct ImageLayoutInfo
+{
+    ImageLayoutType type;
+    ImageFormatInfo format;
+    uint32_t width; // Level 0, in pixels
+    uint32_t height;
+    uint32_t depth; // Slices of a 3D image, 1 otherwise
+    SwizzleSurface surf; // Level 0, in compression blocks
+    uint32_t numLayers;
+    uint32_t numLevels;
+    uint32_t pitchStride; // Non-zero for pitch linear images (and buffers), which have no blocks
+    uint64_t layerStride;
+    uint64_t size;
+    uint32_t alignment;
+
+    constexpr bool isBlockLinear() const
+    {
+        return !pitchStride;
+    }
+
+    // Tile size as a DkTileSize, of the first mip level
+    constexpr uint32_t getTileSize() const
+    {
+        return surf.blockHeight;
+    }
+
+    // Surface of a mip level, to be used with SwizzleRect and friends. Levels are shrunk in pixels and then
+    // rounded up to whole compression blocks, which SwizzleSurface::getLevel can't do on its own.
+    constexpr SwizzleSurface getLevel(uint32_t level) const
+    {
+        if (!isBlockLinear() || !level)
+            return surf;
+
+        SwizzleSurface levelSurf = surf;
+        uint32_t w = (width >> level) ? (width >> level) : 1;
+        uint32_t h = (height >> level) ? (height >> level) : 1;
+        levelSurf.width = (w + format.blockWidth - 1) / format.blockWidth;
+        levelSurf.height = (h + format.blockHeight - 1) / format.blockHeight;
+        levelSurf.depth = (depth >> level) ? (depth >> level) : 1;
+        return levelSurf.getLevel(0);
+    }
+
+    constexpr uint64_t getLevelSize(uint32_t level) const
+    {
+        return isBlockLinear() ? getLevel(level).getSize() : size;
+    }
+
+    // Offset of a mip level from the start of its layer
+    constexpr uint64_t getLevelOffset(uint32_t level) const
+    {
+        uint64_t offset = 0;
+        for (uint32_t i = 0; i < level; i ++)
+            offset += getLevelSize(i);
+        return offset;
+    }
+
+    // Offset of a mip level of a layer (or 3D image) from the start of the image
+    constexpr uint64_t getSubresourceOffset(uint32_t level, uint32_t layer = 0) const
+    {
+        return layer * layerStride + (isBlockLinear() ? getLevelOffset(level) : 0);
+    }
+};
+
+// Calculates the layout deko3d gives an image. Unless a tile size is given, block-linear images get a
+// 16 GOB tile (16 GOBs deep too for 3D images), shrunk to fit the first level the same way it is shrunk
+// for the following ones. Layers are padded to a whole tile of the first level.
+constexpr ImageLayoutInfo ComputeImageLayout(ImageLayoutParams const& params)
+{
+    ImageLayoutInfo info{};
+    info.type = params.type;
+    info.format = params.format;
+    info.width = params.width;
+    info.height = params.height;
+    info.depth = 1;
+    info.numLevels = params.mipLevels ? params.mipLevels : 1;
+    info.numLayers = 1;
+
+    switch (params.type)
+    {
+        case ImageLayoutType_1D:
+        case ImageLayoutType_Buffer:
+            info.height = 1;
+            break;
+        case ImageLayoutType_1DArray:
+            info.height = 1;
+            info.numLayers = params.depth;
+            break;
+        case ImageLayoutType_2D:
+            break;
+        case ImageLayoutType_3D:
+            info.depth = params.depth;
+            break;
+        case ImageLayoutType_2DArray:
+        case ImageLayoutType_Cubemap:
+        case ImageLayoutType_CubemapArray:
+            info.numLayers = params.depth;
+            break;
+    }
+
+    SwizzleSurface& surf = info.surf;
+    surf.width = (info.width + params.format.blockWidth - 1) / params.format.blockWidth;
+    surf.height = (info.height + params.format.blockHeight - 1) / params.format.blockHeight;
+    surf.depth = info.depth;
+    surf.bytesPerPixel = params.format.bytesPerBlock;
+
+    if (params.type == ImageLayoutType_Buffer || params.pitchStride)
+    {
+        // Pitch linear images have a single level and layer, and buffers are just their bytes
+        info.numLevels = 1;
+        info.numLayers = 1;
+        info.pitchStride = params.type == ImageLayoutType_Buffer ? surf.width * surf.bytesPerPixel : params.pitchStride;
+        info.size = uint64_t(info.pitchStride) * surf.height;
+        info.layerStride = info.size;
+        info.alignment = IMAGE_LINEAR_STRIDE_ALIGNMENT;
+        return info;
+    }
+
+    if (params.tileSize >= 0)
+        surf.blockHeight = params.tileSize;
+    else
+    {
+        surf.blockHeight = 4; // DkTileSize_SixteenGobs
+        surf.blockDepth = params.type == ImageLayoutType_3D ? 4 : 0;
+        surf = surf.getLevel(0);
+    }
+
+    info.layerStride = (info.getLevelOffset(info.numLevels) + surf.getBlockSize() - 1) &~ uint64_t(surf.getBlockSize() - 1);
+    info.size = info.layerStride * info.numLayers;
+    info.alignment = surf.getBlockSize();
+    return info;
+}
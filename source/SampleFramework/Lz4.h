@@ -0,0 +1,115 @@
+/*
+** Sample Framework for deko3d Applications
+**   Lz4.h: LZ4-compressed asset format definitions and block decompressor
+*/
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// This header is deliberately self-contained so that host tools can use it too
+
+// Compressed assets are a small header followed by a single raw LZ4 block (no LZ4 frame).
+// The decompressor supports in-place operation: if the compressed block is placed at the very end
+// of a buffer of size + DKLZ_INPLACE_MARGIN(compressed_sz) bytes, it can be decompressed to the start
+// of that same buffer, so loading needs no memory besides the destination itself.
+
+constexpr uint32_t DKLZ_MAGIC = 0x5A4C4B44; // 'DKLZ'
+
+constexpr uint32_t DKLZ_INPLACE_MARGIN(uint32_t compressed_sz)
+{
+    return (compressed_sz >> 8) + 32; // Same bound as LZ4_DECOMPRESS_INPLACE_MARGIN
+}
+
+struct DklzHeader
+{
+    uint32_t magic; // DKLZ_MAGIC
+    uint32_t header_sz; // sizeof(DklzHeader)
+    uint32_t size; // Decompressed size
+    uint32_t compressed_sz;
+};
+
+static_assert(sizeof(DklzHeader) == 16, "Bad DklzHeader size");
+
+// Decompresses an LZ4 block, which must expand to exactly dstSize bytes. Returns false on malformed
+// input, including input that would make an in-place decompression overwrite data not yet read.
+inline bool Lz4Decompress(void const* src, uint32_t srcSize, void* dst, uint32_t dstSize)
+{
+    auto ip = static_cast<uint8_t const*>(src);
+    auto iend = ip + srcSize;
+    auto op = static_cast<uint8_t*>(dst);
+    auto ostart = op;
+    auto oend = op + dstSize;
+
+    // While the unread input overlaps the output buffer, writes must stay behind it
+    auto writeLimit = [&](uint8_t const* readPos) -> uint8_t const*
+    {
+        return readPos >= ostart && readPos < oend ? readPos : oend;
+    };
+
+    auto readLength = [&](size_t& len) -> bool
+    {
+        uint8_t b;
+        do
+        {
+            if (ip >= iend)
+                return false;
+            b = *ip++;
+            len += b;
+        } while (b == 255);
+        return true;
+    };
+
+    for (;;)
+    {
+        if (ip >= iend)
+            return false;
+
+        uint8_t token = *ip++;
+        size_t len = token >> 4;
+        if (len == 15 && !readLength(len))
+            return false;
+
+        if (len > size_t(iend - ip) || len > size_t(writeLimit(ip + len) - op))
+            return false;
+
+        memmove(op, ip, len);
+        op += len;
+        ip += len;
+
+        // The last sequence only has literals
+        if (ip == iend)
+            break;
+
+        if (iend - ip < 2)
+            return false;
+
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (!offset || offset > size_t(op - ostart))
+            return false;
+
+        len = token & 15;
+        if (len == 15 && !readLength(len))
+            return false;
+        len += 4;
+
+        if (len > size_t(writeLimit(ip) - op))
+            return false;
+
+        uint8_t const* match = op - offset;
+        if (offset >= len)
+        {
+            memcpy(op, match, len);
+            op += len;
+        }
+        else
+        {
+            // Overlapping match, repeating the last offset bytes
+            while (len--)
+                *op++ = *match++;
+        }
+    }
+
+    return op == oend;
+}
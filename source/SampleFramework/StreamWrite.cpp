@@ -0,0 +1,166 @@
+/*
+** Sample Framework for deko3d Applications
+**   StreamWrite.cpp: Bulk writes to CPU-uncached memory
+*/
+#include "StreamWrite.h"
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    constexpr size_t StoreSize = 16;
+    constexpr size_t RunSize = 4 * StoreSize;
+
+#if defined(__SSE2__)
+    using Vector = __m128i;
+
+    inline Vector load(uint8_t const* src)
+    {
+        return _mm_loadu_si128(reinterpret_cast<__m128i const*>(src));
+    }
+
+    // dst is always aligned to StoreSize
+    inline void store(uint8_t* dst, Vector v)
+    {
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst), v);
+    }
+
+    inline void storePair(uint8_t* dst, Vector v0, Vector v1)
+    {
+        store(dst, v0);
+        store(dst + StoreSize, v1);
+    }
+
+    inline void finish()
+    {
+        // Non-temporal stores are weakly ordered, make them visible before anything that follows
+        _mm_sfence();
+    }
+#elif defined(__ARM_NEON)
+    using Vector = uint8x16_t;
+
+    inline Vector load(uint8_t const* src)
+    {
+        return vld1q_u8(src);
+    }
+
+    inline void store(uint8_t* dst, Vector v)
+    {
+        vst1q_u8(dst, v);
+    }
+
+    // AArch64 only has non-temporal stores for pairs of registers
+    inline void storePair(uint8_t* dst, Vector v0, Vector v1)
+    {
+#if defined(__aarch64__)
+        asm volatile("stnp %q1, %q2, [%0]" : : "r"(dst), "w"(v0), "w"(v1) : "memory");
+#else
+        vst1q_u8(dst, v0);
+        vst1q_u8(dst + StoreSize, v1);
+#endif
+    }
+
+    inline void finish()
+    {
+    }
+#else
+    struct Vector
+    {
+        uint8_t bytes[StoreSize];
+    };
+
+    inline Vector load(uint8_t const* src)
+    {
+        Vector v;
+        memcpy(v.bytes, src, StoreSize);
+        return v;
+    }
+
+    inline void store(uint8_t* dst, Vector v)
+    {
+        memcpy(dst, v.bytes, StoreSize);
+    }
+
+    inline void storePair(uint8_t* dst, Vector v0, Vector v1)
+    {
+        store(dst, v0);
+        store(dst + StoreSize, v1);
+    }
+
+    inline void finish()
+    {
+    }
+#endif
+
+    // Number of bytes to write before dst is aligned to StoreSize
+    inline size_t alignHead(void* dst, size_t size)
+    {
+        size_t head = -reinterpret_cast<uintptr_t>(dst) & (StoreSize - 1);
+        return head < size ? head : size;
+    }
+}
+
+void StreamCopy(void* dst, void const* src, size_t size)
+{
+    auto out = static_cast<uint8_t*>(dst);
+    auto in = static_cast<uint8_t const*>(src);
+
+    size_t head = alignHead(out, size);
+    memcpy(out, in, head);
+    out += head;
+    in += head;
+    size -= head;
+
+    for (; size >= RunSize; size -= RunSize, out += RunSize, in += RunSize)
+    {
+        Vector v0 = load(in + 0*StoreSize);
+        Vector v1 = load(in + 1*StoreSize);
+        Vector v2 = load(in + 2*StoreSize);
+        Vector v3 = load(in + 3*StoreSize);
+        storePair(out + 0*StoreSize, v0, v1);
+        storePair(out + 2*StoreSize, v2, v3);
+    }
+    for (; size >= StoreSize; size -= StoreSize, out += StoreSize, in += StoreSize)
+        store(out, load(in));
+    finish();
+
+    memcpy(out, in, size);
+}
+
+bool StreamFill(void* dst, void const* pattern, uint32_t patternSize, size_t size)
+{
+    if (!patternSize || patternSize > StoreSize || (patternSize & (patternSize - 1)))
+        return false;
+
+    // Two stores' worth of the pattern, so that a store can start at any phase of it
+    uint8_t buf[2*StoreSize];
+    for (size_t i = 0; i < sizeof(buf); i += patternSize)
+        memcpy(buf + i, pattern, patternSize);
+
+    auto out = static_cast<uint8_t*>(dst);
+    size_t head = alignHead(out, size);
+    memcpy(out, buf, head);
+    out += head;
+    size -= head;
+
+    // Every store starts at the same phase of the pattern, since it divides the store size
+    uint8_t const* phase = buf + head % patternSize;
+    Vector v = load(phase);
+    for (; size >= RunSize; size -= RunSize, out += RunSize)
+    {
+        storePair(out + 0*StoreSize, v, v);
+        storePair(out + 2*StoreSize, v, v);
+    }
+    for (; size >= StoreSize; size -= StoreSize, out += StoreSize)
+        store(out, v);
+    finish();
+
+    memcpy(out, phase, size);
+    return true;
+}
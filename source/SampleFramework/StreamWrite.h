@@ -0,0 +1,22 @@
+/*
+** Sample Framework for deko3d Applications
+**   StreamWrite.h: Bulk writes to CPU-uncached memory
+*/
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// This header is deliberately self-contained so that host tools can use it too
+
+// Stores to CpuUncached memory bypass the cache, so each one goes out to memory on its own unless the CPU
+// can merge it with its neighbours. These write in address order, in runs of four 16-byte-aligned 16-byte
+// stores, which lets the stores merge into full bursts. The runs use non-temporal stores on SSE2 and
+// AArch64 (stnp of register pairs); the unaligned head and tail use plain stores. Small scattered stores,
+// like a memcpy per pixel, can't be merged and are many times slower.
+
+// Copies size bytes
+void StreamCopy(void* dst, void const* src, size_t size);
+
+// Fills size bytes with a repeating pattern of patternSize bytes. The pattern must divide the store size,
+// so only 1, 2, 4, 8 and 16 bytes are supported; returns false without writing anything for others.
+bool StreamFill(void* dst, void const* pattern, uint32_t patternSize, size_t size);
@@ -0,0 +1,303 @@
+/*
+** Sample Framework for deko3d Applications
+**   Swizzle.cpp: Conversion between pitch-linear and block-linear image data
+*/
+#include "Swizzle.h"
+
+#include <string.h>
+
+#include <array>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    // Each row of a GOB is made of four 16-byte sectors, which are contiguous in linear memory
+    constexpr uint32_t SECTOR_SIZE = 16;
+
+    // The direction of a copy is picked by which side is const: tiled to linear or linear to tiled
+    inline void copyBytes(uint8_t* tiled, uint8_t const* linear, uint32_t size)
+    {
+        memcpy(tiled, linear, size);
+    }
+
+    inline void copyBytes(uint8_t const* tiled, uint8_t* linear, uint32_t size)
+    {
+        memcpy(linear, tiled, size);
+    }
+
+    inline void copySector(uint8_t* dst, uint8_t const* src)
+    {
+#if defined(__SSE2__)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_loadu_si128(reinterpret_cast<__m128i const*>(src)));
+#elif defined(__ARM_NEON)
+        vst1q_u8(dst, vld1q_u8(src));
+#else
+        memcpy(dst, src, SECTOR_SIZE);
+#endif
+    }
+
+    // Copies one 64-byte row of a GOB, made of the sectors at 0, 32, 256 and 288
+    inline void copyGobRow(uint8_t* tiled, uint8_t const* linear)
+    {
+        copySector(tiled +   0, linear +  0);
+        copySector(tiled +  32, linear + 16);
+        copySector(tiled + 256, linear + 32);
+        copySector(tiled + 288, linear + 48);
+    }
+
+    inline void copyGobRow(uint8_t const* tiled, uint8_t* linear)
+    {
+        copySector(linear +  0, tiled +   0);
+        copySector(linear + 16, tiled +  32);
+        copySector(linear + 32, tiled + 256);
+        copySector(linear + 48, tiled + 288);
+    }
+
+    // Writes a whole GOB in memory order. Each 64 bytes of it hold 32 bytes of two consecutive rows,
+    // interleaved by sector, and the right half of the GOB follows the left one.
+    inline void copyGob(uint8_t* gob, uint8_t const* linear, uint32_t pitch)
+    {
+        for (uint32_t s = 0; s < GOB_SIZE / SECTOR_SIZE; s += 4, gob += 4 * SECTOR_SIZE)
+        {
+            uint8_t const* row = linear + ((s >> 2) & 3) * 2 * pitch + ((s >> 4) & 1) * 32;
+            copySector(gob +  0, row);
+            copySector(gob + 16, row + pitch);
+            copySector(gob + 32, row + 16);
+            copySector(gob + 48, row + pitch + 16);
+        }
+    }
+
+    // Copies bytes [xb, xe) of a row, one sector (or part of one) at a time. When the pixel size is known,
+    // partial sectors are made of whole pixels and go through fixed-size copies instead of a memcpy call
+    // (for 1 and 2 byte pixels, the call still wins).
+    template <uint32_t BytesPerPixel, typename Tiled, typename Linear>
+    inline void copySpan(Tiled* row, uint32_t gobStride, Linear*& linear, uint32_t& xb, uint32_t xe)
+    {
+        while (xb < xe)
+        {
+            uint32_t n = SECTOR_SIZE - (xb & (SECTOR_SIZE - 1));
+            if (n > xe - xb)
+                n = xe - xb;
+            Tiled* out = row + SwizzleRowByteOffset(xb, gobStride);
+            if (BytesPerPixel >= 4)
+                for (uint32_t i = 0; i < n; i += BytesPerPixel)
+                    copyBytes(out + i, linear + i, BytesPerPixel);
+            else
+                copyBytes(out, linear, n);
+            linear += n;
+            xb += n;
+        }
+    }
+
+    template <uint32_t BytesPerPixel, typename Tiled, typename Linear>
+    inline void copyRow(Tiled* row, uint32_t gobStride, Linear* linear, uint32_t xb, uint32_t xe)
+    {
+        // Partial GOB on the left
+        uint32_t head = (xb + GOB_SIZE_X - 1) &~ (GOB_SIZE_X - 1);
+        copySpan<BytesPerPixel>(row, gobStride, linear, xb, head < xe ? head : xe);
+
+        // Whole GOB rows
+        Tiled* gob = row + (xb >> GOB_SIZE_X_SHIFT) * gobStride;
+        for (; xb + GOB_SIZE_X <= xe; xb += GOB_SIZE_X, linear += GOB_SIZE_X, gob += gobStride)
+            copyGobRow(gob, linear);
+
+        // Partial GOB on the right
+        copySpan<BytesPerPixel>(row, gobStride, linear, xb, xe);
+    }
+
+    // Copies a box between linear and block-linear memory. BytesPerPixel and BlockHeight are compile-time
+    // constants in the specialized kernels, so the address math folds into shifts and masks; a value of 0
+    // (for BytesPerPixel) or ~0 (for BlockHeight) reads it from the surface instead.
+    template <uint32_t BytesPerPixel, uint32_t BlockHeight, typename Tiled, typename Linear>
+    void copyBox(SwizzleSurface const& surf, Tiled* tiled, Linear* linear, uint32_t pitch, uint32_t slicePitch,
+        uint32_t x, uint32_t y, uint32_t z, uint32_t w, uint32_t h, uint32_t d)
+    {
+        const uint32_t bpp = BytesPerPixel ? BytesPerPixel : surf.bytesPerPixel;
+        const uint32_t blockHeight = BlockHeight != ~0U ? BlockHeight : surf.blockHeight;
+        const uint32_t blockDepth = surf.blockDepth;
+        const uint32_t gobStride = GOB_SIZE << (blockHeight + blockDepth);
+        const size_t blockRowSize = size_t(surf.getGobsPerRow()) * gobStride;
+        const size_t blockSliceSize = blockRowSize * surf.getBlockRows();
+        const uint32_t xb = x * bpp;
+        const uint32_t xe = (x + w) * bpp;
+
+        // When swizzling, whole GOBs inside the box are written one at a time in memory order, so that the
+        // block-linear side is written sequentially. This matters most for uncached memory, where scattered
+        // stores can't be combined into bursts. The partial GOBs around them are copied row by row.
+        // Deswizzling stays row by row, which keeps the writes to the linear side sequential instead.
+        constexpr bool WholeGobs = std::is_const<Linear>::value;
+        const uint32_t gobX0 = (xb + GOB_SIZE_X - 1) &~ (GOB_SIZE_X - 1), gobX1 = xe &~ (GOB_SIZE_X - 1);
+        const uint32_t gobY0 = (y + GOB_SIZE_Y - 1) &~ (GOB_SIZE_Y - 1), gobY1 = (y + h) &~ (GOB_SIZE_Y - 1);
+        const bool hasGobs = WholeGobs && gobX0 < gobX1 && gobY0 < gobY1;
+
+        for (uint32_t k = z; k < z + d; k ++, linear += slicePitch)
+        {
+            const size_t sliceOffset = (k >> blockDepth) * blockSliceSize +
+                ((size_t(k & ((1U << blockDepth) - 1)) << blockHeight) << GOB_SIZE_SHIFT);
+            auto rowOffset = [&](uint32_t i)
+            {
+                return sliceOffset + (i >> (GOB_SIZE_Y_SHIFT + blockHeight)) * blockRowSize +
+                    (((i >> GOB_SIZE_Y_SHIFT) & ((1U << blockHeight) - 1)) << GOB_SIZE_SHIFT) + SwizzleGobRowOffset(i);
+            };
+
+            Linear* in = linear;
+            for (uint32_t i = y; i < y + h; i ++, in += pitch)
+            {
+                if (!hasGobs || i < gobY0 || i >= gobY1)
+                {
+                    copyRow<BytesPerPixel>(tiled + rowOffset(i), gobStride, in, xb, xe);
+                    continue;
+                }
+
+                Linear* left = in;
+                Linear* right = in + (gobX1 - xb);
+                uint32_t leftX = xb, rightX = gobX1;
+                copySpan<BytesPerPixel>(tiled + rowOffset(i), gobStride, left, leftX, gobX0);
+                copySpan<BytesPerPixel>(tiled + rowOffset(i), gobStride, right, rightX, xe);
+            }
+
+            // Within a row of blocks, the GOBs of a block are contiguous and blocks follow each other
+            if constexpr (WholeGobs)
+            {
+                for (uint32_t blockY = gobY0; hasGobs && blockY < gobY1; )
+                {
+                    uint32_t blockEnd = ((blockY >> (GOB_SIZE_Y_SHIFT + blockHeight)) + 1) << (GOB_SIZE_Y_SHIFT + blockHeight);
+                    if (blockEnd > gobY1)
+                        blockEnd = gobY1;
+                    for (uint32_t gobX = gobX0; gobX < gobX1; gobX += GOB_SIZE_X)
+                        for (uint32_t gobY = blockY; gobY < blockEnd; gobY += GOB_SIZE_Y)
+                            copyGob(tiled + rowOffset(gobY) + (gobX >> GOB_SIZE_X_SHIFT) * gobStride,
+                                linear + size_t(gobY - y) * pitch + (gobX - xb), pitch);
+                    blockY = blockEnd;
+                }
+            }
+        }
+    }
+
+    template <typename Tiled, typename Linear>
+    using BoxKernel = void (*)(SwizzleSurface const&, Tiled*, Linear*, uint32_t, uint32_t,
+        uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t);
+
+    constexpr uint32_t NumKernelFormats = 5; // 1, 2, 4, 8 and 16 bytes per pixel
+    constexpr uint32_t NumKernelHeights = SWIZZLE_MAX_BLOCK_HEIGHT + 1;
+
+    template <typename Tiled, typename Linear>
+    using KernelTable = std::array<std::array<BoxKernel<Tiled, Linear>, NumKernelHeights>, NumKernelFormats>;
+
+    template <typename Tiled, typename Linear, uint32_t BytesPerPixel, uint32_t... BlockHeights>
+    constexpr std::array<BoxKernel<Tiled, Linear>, NumKernelHeights> makeKernelRow(std::integer_sequence<uint32_t, BlockHeights...>)
+    {
+        return {{ &copyBox<BytesPerPixel, BlockHeights, Tiled, Linear>... }};
+    }
+
+    template <typename Tiled, typename Linear, uint32_t... FormatShifts>
+    constexpr KernelTable<Tiled, Linear> makeKernelTable(std::integer_sequence<uint32_t, FormatShifts...>)
+    {
+        return {{ makeKernelRow<Tiled, Linear, 1U << FormatShifts>(std::make_integer_sequence<uint32_t, NumKernelHeights>{})... }};
+    }
+
+    constexpr auto SwizzleKernels = makeKernelTable<uint8_t, uint8_t const>(std::make_integer_sequence<uint32_t, NumKernelFormats>{});
+    constexpr auto DeswizzleKernels = makeKernelTable<uint8_t const, uint8_t>(std::make_integer_sequence<uint32_t, NumKernelFormats>{});
+
+    template <typename Tiled, typename Linear>
+    BoxKernel<Tiled, Linear> selectKernel(KernelTable<Tiled, Linear> const& table, SwizzleSurface const& surf)
+    {
+        uint32_t bpp = surf.bytesPerPixel;
+        if ((bpp & (bpp - 1)) || bpp > (1U << (NumKernelFormats - 1)) || surf.blockHeight >= NumKernelHeights)
+            return &copyBox<0, ~0U, Tiled, Linear>;
+        return table[__builtin_ctz(bpp)][surf.blockHeight];
+    }
+}
+
+void SwizzleBox(SwizzleSurface const& surf, void* dst, void const* src, uint32_t pitch, uint32_t slicePitch,
+    uint32_t x, uint32_t y, uint32_t z, uint32_t w, uint32_t h, uint32_t d)
+{
+    selectKernel(SwizzleKernels, surf)(surf, static_cast<uint8_t*>(dst), static_cast<uint8_t const*>(src), pitch, slicePitch, x, y, z, w, h, d);
+}
+
+void SwizzleRect(SwizzleSurface const& surf, void* dst, void const* src, uint32_t pitch,
+    uint32_t x, uint32_t y, uint32_t w, uint32_t h)
+{
+    SwizzleBox(surf, dst, src, pitch, 0, x, y, 0, w, h, 1);
+}
+
+void SwizzleImage(SwizzleSurface const& surf, void* dst, void const* src, uint32_t pitch)
+{
+    SwizzleBox(surf, dst, src, pitch, pitch * surf.height, 0, 0, 0, surf.width, surf.height, surf.depth);
+}
+
+bool SwizzleRegions(SwizzleSurface const& surf, void* dst, void const* src, uint32_t pitch,
+    SwizzleRegion const* regions, uint32_t numRegions)
+{
+    if (!surf.bytesPerPixel || (GOB_SIZE_X % surf.bytesPerPixel))
+        return false;
+
+    const uint32_t cols = surf.getGobsPerRow();
+    const uint32_t rows = surf.getBlockRows();
+    const uint32_t gobWidth = GOB_SIZE_X / surf.bytesPerPixel;
+    const uint32_t rowHeight = GOB_SIZE_Y << surf.blockHeight;
+
+    // Mark the blocks touched by each region
+    std::vector<bool> dirty(size_t(cols) * rows);
+    for (uint32_t i = 0; i < numRegions; i ++)
+    {
+        auto const& r = regions[i];
+        if (r.x >= surf.width || r.y >= surf.height || !r.width || !r.height)
+            continue;
+        uint32_t x1 = r.width < surf.width - r.x ? r.x + r.width : surf.width;
+        uint32_t y1 = r.height < surf.height - r.y ? r.y + r.height : surf.height;
+        for (uint32_t row = r.y / rowHeight; row <= (y1 - 1) / rowHeight; row ++)
+            for (uint32_t col = r.x / gobWidth; col <= (x1 - 1) / gobWidth; col ++)
+                dirty[size_t(row) * cols + col] = true;
+    }
+
+    // Write each run of dirty blocks in a row of blocks with a single rectangle
+    auto in = static_cast<uint8_t const*>(src);
+    for (uint32_t row = 0; row < rows; row ++)
+    {
+        uint32_t y = row * rowHeight;
+        uint32_t h = surf.height - y < rowHeight ? surf.height - y : rowHeight;
+        for (uint32_t col = 0; col < cols; )
+        {
+            if (!dirty[size_t(row) * cols + col])
+            {
+                col ++;
+                continue;
+            }
+
+            uint32_t first = col;
+            while (col < cols && dirty[size_t(row) * cols + col])
+                col ++;
+
+            uint32_t x = first * gobWidth;
+            uint32_t w = (col * gobWidth < surf.width ? col * gobWidth : surf.width) - x;
+            SwizzleRect(surf, dst, in + size_t(y) * pitch + x * surf.bytesPerPixel, pitch, x, y, w, h);
+        }
+    }
+    return true;
+}
+
+void DeswizzleBox(SwizzleSurface const& surf, void* dst, uint32_t pitch, uint32_t slicePitch, void const* src,
+    uint32_t x, uint32_t y, uint32_t z, uint32_t w, uint32_t h, uint32_t d)
+{
+    selectKernel(DeswizzleKernels, surf)(surf, static_cast<uint8_t const*>(src), static_cast<uint8_t*>(dst), pitch, slicePitch, x, y, z, w, h, d);
+}
+
+void DeswizzleRect(SwizzleSurface const& surf, void* dst, uint32_t pitch, void const* src,
+    uint32_t x, uint32_t y, uint32_t w, uint32_t h)
+{
+    DeswizzleBox(surf, dst, pitch, 0, src, x, y, 0, w, h, 1);
+}
+
+void DeswizzleImage(SwizzleSurface const& surf, void* dst, uint32_t pitch, void const* src)
+{
+    DeswizzleBox(surf, dst, pitch, pitch * surf.height, src, 0, 0, 0, surf.width, surf.height, surf.depth);
+}
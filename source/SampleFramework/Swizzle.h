@@ -0,0 +1,178 @@
+/*
+** Sample Framework for deko3d Applications
+**   Swizzle.h: Conversion between pitch-linear and block-linear image data
+*/
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// This header is deliberately self-contained so that host tools can use it too
+
+// Block-linear images are made of GOBs (groups of bytes), 64 bytes wide and 8 rows tall.
+// GOBs are stacked vertically into blocks of 2^blockHeight GOBs, and blocks are laid out in rows.
+constexpr uint32_t GOB_SIZE_X = 64;
+constexpr uint32_t GOB_SIZE_Y = 8;
+constexpr uint32_t GOB_SIZE_Z = 1;
+constexpr uint32_t GOB_SIZE = GOB_SIZE_X * GOB_SIZE_Y * GOB_SIZE_Z;
+
+constexpr size_t GOB_SIZE_X_SHIFT = 6;
+constexpr size_t GOB_SIZE_Y_SHIFT = 3;
+constexpr size_t GOB_SIZE_Z_SHIFT = 0;
+constexpr size_t GOB_SIZE_SHIFT = GOB_SIZE_X_SHIFT + GOB_SIZE_Y_SHIFT + GOB_SIZE_Z_SHIFT;
+
+// Largest block height (and block depth) the GPU supports, 32 GOBs
+constexpr uint32_t SWIZZLE_MAX_BLOCK_HEIGHT = 5;
+
+// Offset of byte xb of a row within a GOB row, relative to the start of the row in the first GOB.
+// GOB rows are made of four 16-byte sectors, at 0, 32, 256 and 288.
+constexpr size_t SwizzleRowByteOffset(uint32_t xb, uint32_t gobStride)
+{
+    return size_t(xb >> GOB_SIZE_X_SHIFT) * gobStride + ((xb >> 5) & 1) * 256 + ((xb >> 4) & 1) * 32 + (xb & 15);
+}
+
+// Offset of row y of a GOB, from the start of the GOB
+constexpr uint32_t SwizzleGobRowOffset(uint32_t y)
+{
+    return ((y & (GOB_SIZE_Y - 1)) >> 1) * 64 + (y & 1) * 16;
+}
+
+// Dimensions of a block-linear image. For compressed formats, width/height count compression blocks
+// and bytesPerPixel is the size of one of them.
+// 3D images also stack 2^blockDepth GOBs in z inside each block (after the 2^blockHeight GOBs in y),
+// and blocks are laid out row by row, then slice by slice.
+struct SwizzleSurface
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t bytesPerPixel;
+    uint32_t blockHeight; // log2 of the number of GOBs per block, like DkTileSize
+    uint32_t depth = 1;
+    uint32_t blockDepth = 0; // log2 of the number of GOBs per block in z
+
+    constexpr uint32_t getGobsPerRow() const
+    {
+        return (width * bytesPerPixel + GOB_SIZE_X - 1) >> GOB_SIZE_X_SHIFT;
+    }
+
+    constexpr uint32_t getBlockRows() const
+    {
+        return (height + (GOB_SIZE_Y << blockHeight) - 1) >> (GOB_SIZE_Y_SHIFT + blockHeight);
+    }
+
+    constexpr uint32_t getBlockSlices() const
+    {
+        return (depth + (GOB_SIZE_Z << blockDepth) - 1) >> (GOB_SIZE_Z_SHIFT + blockDepth);
+    }
+
+    constexpr uint32_t getBlockSize() const
+    {
+        return GOB_SIZE << (blockHeight + blockDepth);
+    }
+
+    // Size of one row of blocks
+    constexpr uint32_t getBlockRowSize() const
+    {
+        return getGobsPerRow() * getBlockSize();
+    }
+
+    constexpr uint64_t getSize() const
+    {
+        return uint64_t(getBlockSlices()) * getBlockRows() * getBlockRowSize();
+    }
+
+    // Offset of the start of row y of slice z within the first column of GOBs
+    constexpr size_t getRowOffset(uint32_t y, uint32_t z = 0) const
+    {
+        const uint32_t gobY = (y >> GOB_SIZE_Y_SHIFT) & ((1U << blockHeight) - 1);
+        const uint32_t gobZ = (z >> GOB_SIZE_Z_SHIFT) & ((1U << blockDepth) - 1);
+        const size_t block = size_t(z >> (GOB_SIZE_Z_SHIFT + blockDepth)) * getBlockRows() + (y >> (GOB_SIZE_Y_SHIFT + blockHeight));
+        return block * getBlockRowSize() + (((gobZ << blockHeight) | gobY) << GOB_SIZE_SHIFT) + SwizzleGobRowOffset(y);
+    }
+
+    // Distance between horizontally adjacent GOBs
+    constexpr uint32_t getGobStride() const
+    {
+        return getBlockSize();
+    }
+
+    constexpr size_t getOffset(uint32_t x, uint32_t y, uint32_t z = 0) const
+    {
+        return getRowOffset(y, z) + SwizzleRowByteOffset(x * bytesPerPixel, getGobStride());
+    }
+
+    // Mip level of the image. The GPU shrinks blocks that would be more than twice as tall or deep as the level.
+    // Dimensions are halved as they are, so for compressed formats, where they count compression blocks
+    // and levels must be rounded up to whole blocks from their size in pixels, use ImageLayoutInfo::getLevel.
+    constexpr SwizzleSurface getLevel(uint32_t level) const
+    {
+        SwizzleSurface surf = *this;
+        surf.width = (width >> level) ? (width >> level) : 1;
+        surf.height = (height >> level) ? (height >> level) : 1;
+        surf.depth = (depth >> level) ? (depth >> level) : 1;
+        while (surf.blockHeight && (GOB_SIZE_Y << (surf.blockHeight - 1)) >= surf.height)
+            surf.blockHeight --;
+        while (surf.blockDepth && (GOB_SIZE_Z << (surf.blockDepth - 1)) >= surf.depth)
+            surf.blockDepth --;
+        return surf;
+    }
+
+    // Offset of a mip level from the start of the image (or of its layer)
+    constexpr uint64_t getLevelOffset(uint32_t level) const
+    {
+        uint64_t offset = 0;
+        for (uint32_t i = 0; i < level; i ++)
+            offset += getLevel(i).getSize();
+        return offset;
+    }
+
+    // Distance between the layers of an array image with numLevels mip levels
+    constexpr uint64_t getLayerStride(uint32_t numLevels) const
+    {
+        return (getLevelOffset(numLevels) + getBlockSize() - 1) &~ uint64_t(getBlockSize() - 1);
+    }
+};
+
+// Byte offset of a pixel within a 2D block-linear image
+constexpr size_t Swizzle(uint32_t width, uint32_t bytes_per_pixel, uint32_t block_height, uint32_t origin_x, uint32_t origin_y)
+{
+    return SwizzleSurface{width, 0, bytes_per_pixel, block_height}.getOffset(origin_x, origin_y);
+}
+
+// A rectangle of pixels within an image
+struct SwizzleRegion
+{
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+};
+
+// Converts a w*h rectangle of pitch-linear pixels (rows of pitch bytes) into a block-linear image at (x, y).
+// A pitch of 0 repeats the same source row, which is handy for solid fills.
+void SwizzleRect(SwizzleSurface const& surf, void* dst, void const* src, uint32_t pitch,
+    uint32_t x, uint32_t y, uint32_t w, uint32_t h);
+
+// Same for a w*h*d box of a 3D image, with slices of linear data slicePitch bytes apart
+void SwizzleBox(SwizzleSurface const& surf, void* dst, void const* src, uint32_t pitch, uint32_t slicePitch,
+    uint32_t x, uint32_t y, uint32_t z, uint32_t w, uint32_t h, uint32_t d);
+
+// Converts a whole pitch-linear image (rows of pitch bytes, slices of pitch*height bytes) to block-linear
+void SwizzleImage(SwizzleSurface const& surf, void* dst, void const* src, uint32_t pitch);
+
+// Reads a w*h rectangle at (x, y) of a block-linear image back into pitch-linear rows of pitch bytes
+void DeswizzleRect(SwizzleSurface const& surf, void* dst, uint32_t pitch, void const* src,
+    uint32_t x, uint32_t y, uint32_t w, uint32_t h);
+
+void DeswizzleBox(SwizzleSurface const& surf, void* dst, uint32_t pitch, uint32_t slicePitch, void const* src,
+    uint32_t x, uint32_t y, uint32_t z, uint32_t w, uint32_t h, uint32_t d);
+
+// Converts a whole block-linear image back to pitch-linear
+void DeswizzleImage(SwizzleSurface const& surf, void* dst, uint32_t pitch, void const* src);
+
+// Rewrites the parts of a 2D block-linear image covered by the given regions, from a pitch-linear copy of
+// the whole image (rows of pitch bytes). Regions are snapped outwards to whole blocks (one GOB wide) and
+// merged, so every affected block is written once, whole, no matter how many regions touch it.
+// Only pixel sizes that divide the GOB width (1, 2, 4, 8 and 16 bytes) are supported, so that blocks
+// start on whole pixels. Returns false without writing anything for others, such as 12-byte RGB32.
+bool SwizzleRegions(SwizzleSurface const& surf, void* dst, void const* src, uint32_t pitch,
+    SwizzleRegion const* regions, uint32_t numRegions);
@@ -0,0 +1,134 @@
+/*
+** Sample Framework for deko3d Applications
+**   SwizzleThreadPool.cpp: Splits large swizzles across worker threads
+*/
+#include "SwizzleThreadPool.h"
+
+#ifdef __SWITCH__
+#include <switch.h>
+#endif
+
+SwizzleThreadPool::SwizzleThreadPool(unsigned numThreads, uint32_t minTaskSize) :
+    m_task{}, m_numTasks{}, m_nextTask{}, m_numStarted{}, m_generation{}, m_busy{}, m_stop{}, m_minTaskSize{minTaskSize}
+{
+    for (unsigned i = 1; i < numThreads; i ++)
+        m_threads.emplace_back(&SwizzleThreadPool::workerMain, this);
+}
+
+SwizzleThreadPool::~SwizzleThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stop = true;
+    }
+    m_start.notify_all();
+
+    for (auto& t : m_threads)
+        t.join();
+}
+
+void SwizzleThreadPool::workerMain()
+{
+#ifdef __SWITCH__
+    // Threads are created on the default core, spread the workers over the other application cores
+    int core = (m_numStarted.fetch_add(1, std::memory_order_relaxed) + 1) % 3;
+    svcSetThreadCoreMask(CUR_THREAD_HANDLE, core, 1U << core);
+#endif
+
+    unsigned generation = 0;
+    std::unique_lock<std::mutex> lock{m_mutex};
+    for (;;)
+    {
+        m_start.wait(lock, [&] { return m_stop || m_generation != generation; });
+        if (m_stop)
+            break;
+        generation = m_generation;
+
+        lock.unlock();
+        runTasks();
+        lock.lock();
+
+        if (--m_busy == 0)
+            m_done.notify_one();
+    }
+}
+
+void SwizzleThreadPool::runTasks()
+{
+    for (uint32_t i; (i = m_nextTask.fetch_add(1, std::memory_order_relaxed)) < m_numTasks; )
+        (*m_task)(i);
+}
+
+void SwizzleThreadPool::run(uint32_t numTasks, Task const& task)
+{
+    if (m_threads.empty() || numTasks <= 1)
+    {
+        for (uint32_t i = 0; i < numTasks; i ++)
+            task(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_task = &task;
+        m_numTasks = numTasks;
+        m_nextTask.store(0, std::memory_order_relaxed);
+        m_busy = m_threads.size();
+        m_generation ++;
+    }
+    m_start.notify_all();
+
+    runTasks();
+
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_done.wait(lock, [this] { return m_busy == 0; });
+    m_task = nullptr;
+}
+
+uint32_t SwizzleThreadPool::getRowsPerTask(SwizzleSurface const& surf) const
+{
+    uint32_t rowSize = surf.getBlockRowSize();
+    return rowSize ? (m_minTaskSize + rowSize - 1) / rowSize : 1;
+}
+
+template <typename Func>
+void SwizzleThreadPool::forEachBlockRow(SwizzleSurface const& surf, Func&& func)
+{
+    uint32_t blockRows = surf.getBlockRows();
+    uint32_t totalRows = blockRows * surf.getBlockSlices();
+    uint32_t rowsPerTask = getRowsPerTask(surf);
+    uint32_t rowHeight = GOB_SIZE_Y << surf.blockHeight;
+    uint32_t sliceDepth = GOB_SIZE_Z << surf.blockDepth;
+
+    run((totalRows + rowsPerTask - 1) / rowsPerTask, [&](uint32_t task)
+    {
+        uint32_t end = (task + 1) * rowsPerTask < totalRows ? (task + 1) * rowsPerTask : totalRows;
+        for (uint32_t row = task * rowsPerTask; row < end; row ++)
+        {
+            uint32_t y = (row % blockRows) * rowHeight, z = (row / blockRows) * sliceDepth;
+            uint32_t h = surf.height - y < rowHeight ? surf.height - y : rowHeight;
+            uint32_t d = surf.depth - z < sliceDepth ? surf.depth - z : sliceDepth;
+            func(y, z, h, d);
+        }
+    });
+}
+
+void SwizzleThreadPool::swizzleImage(SwizzleSurface const& surf, void* dst, void const* src, uint32_t pitch)
+{
+    uint32_t slicePitch = pitch * surf.height;
+    forEachBlockRow(surf, [&](uint32_t y, uint32_t z, uint32_t h, uint32_t d)
+    {
+        auto in = static_cast<uint8_t const*>(src) + size_t(z) * slicePitch + size_t(y) * pitch;
+        SwizzleBox(surf, dst, in, pitch, slicePitch, 0, y, z, surf.width, h, d);
+    });
+}
+
+void SwizzleThreadPool::deswizzleImage(SwizzleSurface const& surf, void* dst, uint32_t pitch, void const* src)
+{
+    uint32_t slicePitch = pitch * surf.height;
+    forEachBlockRow(surf, [&](uint32_t y, uint32_t z, uint32_t h, uint32_t d)
+    {
+        auto out = static_cast<uint8_t*>(dst) + size_t(z) * slicePitch + size_t(y) * pitch;
+        DeswizzleBox(surf, out, pitch, slicePitch, src, 0, y, z, surf.width, h, d);
+    });
+}
@@ -0,0 +1,75 @@
+/*
+** Sample Framework for deko3d Applications
+**   SwizzleThreadPool.h: Splits large swizzles across worker threads
+*/
+#pragma once
+#include "Swizzle.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// This header is deliberately self-contained so that host tools can use it too
+
+// Rows of blocks never share any memory, so each task swizzles a run of whole block rows (of every slice
+// for 3D images). The calling thread works on tasks too, so a pool of N threads only spawns N-1 workers.
+class SwizzleThreadPool
+{
+public:
+    // Below this much data per task, waking up another thread costs more than it saves
+    static constexpr uint32_t DefaultMinTaskSize = 256*1024;
+
+private:
+    using Task = std::function<void(uint32_t)>;
+
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    std::vector<std::thread> m_threads;
+    Task const* m_task;
+    uint32_t m_numTasks;
+    std::atomic<uint32_t> m_nextTask;
+    std::atomic<unsigned> m_numStarted;
+    unsigned m_generation;
+    unsigned m_busy;
+    bool m_stop;
+    uint32_t m_minTaskSize;
+
+    void workerMain();
+    void runTasks();
+    void run(uint32_t numTasks, Task const& task);
+    uint32_t getRowsPerTask(SwizzleSurface const& surf) const;
+
+    // Calls func(y, z, height, depth) with the region covered by each row of blocks
+    template <typename Func>
+    void forEachBlockRow(SwizzleSurface const& surf, Func&& func);
+
+public:
+    SwizzleThreadPool(unsigned numThreads, uint32_t minTaskSize = DefaultMinTaskSize);
+    ~SwizzleThreadPool();
+
+    SwizzleThreadPool(SwizzleThreadPool const&) = delete;
+    SwizzleThreadPool& operator=(SwizzleThreadPool const&) = delete;
+
+    unsigned getNumThreads() const
+    {
+        return m_threads.size() + 1;
+    }
+
+    uint32_t getMinTaskSize() const
+    {
+        return m_minTaskSize;
+    }
+
+    void setMinTaskSize(uint32_t size)
+    {
+        m_minTaskSize = size;
+    }
+
+    // Same as SwizzleImage/DeswizzleImage, split across the pool
+    void swizzleImage(SwizzleSurface const& surf, void* dst, void const* src, uint32_t pitch);
+    void deswizzleImage(SwizzleSurface const& surf, void* dst, uint32_t pitch, void const* src);
+};
@@ -22,8 +22,7 @@ class Test final : public CApplication
     std::optional<CMemPool> pool_code;
     std::optional<CMemPool> pool_data;
 
-    CShader vertexShader;
-    CShader fragmentShader;
+    CShader pipelineShaders;
 
     dk::UniqueCmdBuf cmdbuf;
 
@@ -107,8 +106,8 @@ public:
         imageDescriptorSet.allocate(*pool_data);
         samplerDescriptorSet.allocate(*pool_data);
 
-        vertexShader.load(*pool_code, "romfs:/shaders/full_tri_vsh.dksh");
-        fragmentShader.load(*pool_code, "romfs:/shaders/sample_fsh.dksh");
+        // Both stages come from a single file, merged from full_tri_vsh and sample_fsh by dkshmerge
+        pipelineShaders.loadShared(*pool_code, "romfs:/pipelines/full_tri_sample.dksh");
 
         dk::Sampler sampler;
         sampler.setFilter(DkFilter_Linear, DkFilter_Linear);
@@ -166,7 +165,7 @@ public:
 
         cmdbuf.setScissors(0, { { 0, 0, FramebufferWidth, FramebufferHeight } });
         cmdbuf.clearColor(0, DkColorMask_RGBA, 0.0f, 0.25f, 0.0f, 1.0f);
-        cmdbuf.bindShaders(DkStageFlag_GraphicsMask, { vertexShader, fragmentShader });
+        cmdbuf.bindShaders(DkStageFlag_GraphicsMask, { pipelineShaders.find("vert"), pipelineShaders.find("frag") });
         cmdbuf.bindRasterizerState(rasterizerState);
         cmdbuf.bindColorState(colorState);
         cmdbuf.bindColorWriteState(colorWriteState);
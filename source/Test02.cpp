@@ -2,6 +2,7 @@
 #include "SampleFramework/CShader.h"
 #include "SampleFramework/CApplication.h"
 #include "SampleFramework/CMemPool.h"
+#include "SampleFramework/StreamWrite.h"
 
 #include <array>
 #include <optional>
@@ -44,9 +45,11 @@ class Test final : public CApplication
         u8* data;
         int pitch;
 
-        void write(int x, int y, Pixel color)
+        // Rows are written whole and in order, the image lives in uncached memory
+        void fill(int x, int y, int w, int h, Pixel color)
         {
-            memcpy(data + y * pitch + x * sizeof(Pixel), &color, sizeof(color));
+            for (int i = 0; i < h; ++i)
+                StreamFill(data + (y + i) * pitch + x * sizeof(Pixel), &color, sizeof(color), w * sizeof(Pixel));
         }
     };
     Image image;
@@ -98,11 +101,7 @@ public:
 
         image.data = static_cast<u8*>(test_block.getCpuAddr());
         image.pitch = 512*4;
-        for (int y = 0; y < 512; ++y) {
-            for (int x = 0; x < 512; ++x) {
-                image.write(x, y, {96,96,96,255});
-            }
-        }
+        image.fill(0, 0, 512, 512, {96,96,96,255});
 
         dk::Image test_image;
         test_image.initialize(layout_test, test_block, test_allocation.getOffset());
@@ -113,8 +112,8 @@ public:
         imageDescriptorSet.allocate(*pool_data);
         samplerDescriptorSet.allocate(*pool_data);
 
-        vertexShader.load(*pool_code, "romfs:/shaders/full_tri_vsh.dksh");
-        fragmentShader.load(*pool_code, "romfs:/shaders/sample_fsh.dksh");
+        vertexShader.loadShared(*pool_code, "romfs:/shaders/full_tri_vsh.dksh");
+        fragmentShader.loadShared(*pool_code, "romfs:/shaders/sample_fsh.dksh");
 
         dk::Sampler sampler;
         sampler.setFilter(DkFilter_Linear, DkFilter_Linear);
@@ -207,11 +206,7 @@ public:
 
     void writeSquare(unsigned idx, Pixel color) {
         auto [block_x, block_y] = pos(idx);
-        for (int y = 0; y < 64; ++y) {
-            for (int x = 0; x < 64; ++x) {
-                image.write(block_x*64 + x, block_y*64 + y, color);
-            }
-        }
+        image.fill(block_x*64, block_y*64, 64, 64, color);
     }
 
     unsigned squareIdx = 0;
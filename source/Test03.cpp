@@ -2,63 +2,15 @@
 #include "SampleFramework/CShader.h"
 #include "SampleFramework/CApplication.h"
 #include "SampleFramework/CMemPool.h"
+#include "SampleFramework/Swizzle.h"
+#include "SampleFramework/SwizzleThreadPool.h"
 
 #include <array>
 #include <optional>
+#include <vector>
 
 namespace {
 
-constexpr u32 GOB_SIZE_X = 64;
-constexpr u32 GOB_SIZE_Y = 8;
-constexpr u32 GOB_SIZE_Z = 1;
-constexpr u32 GOB_SIZE = GOB_SIZE_X * GOB_SIZE_Y * GOB_SIZE_Z;
-
-constexpr std::size_t GOB_SIZE_X_SHIFT = 6;
-constexpr std::size_t GOB_SIZE_Y_SHIFT = 3;
-constexpr std::size_t GOB_SIZE_Z_SHIFT = 0;
-constexpr std::size_t GOB_SIZE_SHIFT = GOB_SIZE_X_SHIFT + GOB_SIZE_Y_SHIFT + GOB_SIZE_Z_SHIFT;
-
-template <std::size_t N, std::size_t M, u32 Align>
-struct alignas(64) SwizzleTable {
-    static_assert(M * Align == 64, "Swizzle Table does not align to GOB");
-    constexpr SwizzleTable() {
-        for (u32 y = 0; y < N; ++y) {
-            for (u32 x = 0; x < M; ++x) {
-                const u32 x2 = x * Align;
-                values[y][x] = static_cast<u16>(((x2 % 64) / 32) * 256 + ((y % 8) / 2) * 64 +
-                                                ((x2 % 32) / 16) * 32 + (y % 2) * 16 + (x2 % 16));
-            }
-        }
-    }
-    const std::array<u16, M>& operator[](std::size_t index) const {
-        return values[index];
-    }
-    std::array<std::array<u16, M>, N> values{};
-};
-constexpr auto LEGACY_SWIZZLE_TABLE = SwizzleTable<GOB_SIZE_X, GOB_SIZE_X, GOB_SIZE_Z>();
-
-size_t Swizzle(u32 width, u32 bytes_per_pixel, u32 block_height, u32 origin_x, u32 origin_y) {
-    const u32 stride = width * bytes_per_pixel;
-    const u32 gobs_in_x = (stride + GOB_SIZE_X - 1) / GOB_SIZE_X;
-    const u32 block_size = gobs_in_x << (GOB_SIZE_SHIFT + block_height);
-
-    const u32 block_height_mask = (1U << block_height) - 1;
-    const u32 x_shift = static_cast<u32>(GOB_SIZE_SHIFT) + block_height;
-
-    const u32 dst_y = origin_y;
-    const auto& table = LEGACY_SWIZZLE_TABLE[dst_y % GOB_SIZE_Y];
-
-    const u32 block_y = dst_y >> GOB_SIZE_Y_SHIFT;
-    const u32 dst_offset_y =
-         (block_y >> block_height) * block_size +
-        ((block_y & block_height_mask) << GOB_SIZE_SHIFT);
-        
-    const u32 dst_x = origin_x * bytes_per_pixel;
-    const u32 offset_x = (dst_x >> GOB_SIZE_X_SHIFT) << x_shift;
-
-    return dst_offset_y + offset_x + table[dst_x % GOB_SIZE_X];
-}
-
 constexpr unsigned DIM = 4096;
 
 class Test final : public CApplication
@@ -95,13 +47,18 @@ class Test final : public CApplication
     };
     struct Image {
         u8* data;
-        u32 width;
-        u32 block_height;
+        SwizzleSurface surf;
+
+        // Writes a w*h rectangle of pixels read from rows of pitch bytes, a pitch of 0 repeats the first row
+        void write(u32 x, u32 y, u32 w, u32 h, const Pixel* src, u32 pitch)
+        {
+            SwizzleRect(surf, data, src, pitch, x, y, w, h);
+        }
 
-        void write(int x, int y, Pixel color)
+        void fill(u32 x, u32 y, u32 w, u32 h, Pixel color)
         {
-            size_t o = Swizzle(width, 4, block_height, x, y);
-            memcpy(data + o, &color, sizeof(color));
+            std::vector<Pixel> row(w, color);
+            write(x, y, w, h, row.data(), 0);
         }
     };
     Image image;
@@ -152,13 +109,12 @@ public:
         auto test_block = test_allocation.getMemBlock();
 
         image.data = static_cast<u8*>(test_block.getCpuAddr());
-        image.width = DIM;
-        image.block_height = 4;
-        for (u32 y = 0; y < DIM; ++y) {
-            for (u32 x = 0; x < DIM; ++x) {
-                image.write(x, y, {96,96,96,255});
-            }
-        }
+        image.surf = SwizzleSurface{DIM, DIM, sizeof(Pixel), 4};
+
+        // The initial fill covers 64MiB, so spread it over all three application cores
+        std::vector<Pixel> row(DIM, Pixel{96,96,96,255});
+        SwizzleThreadPool{3}.swizzleImage(image.surf, image.data, row.data(), 0);
+        squareColors.fill(row[0]);
 
         dk::Image test_image;
         test_image.initialize(layout_test, test_block, test_allocation.getOffset());
@@ -169,8 +125,8 @@ public:
         imageDescriptorSet.allocate(*pool_data);
         samplerDescriptorSet.allocate(*pool_data);
 
-        vertexShader.load(*pool_code, "romfs:/shaders/full_tri_vsh.dksh");
-        fragmentShader.load(*pool_code, "romfs:/shaders/sample_fsh.dksh");
+        vertexShader.loadShared(*pool_code, "romfs:/shaders/full_tri_vsh.dksh");
+        fragmentShader.loadShared(*pool_code, "romfs:/shaders/sample_fsh.dksh");
 
         dk::Sampler sampler;
         sampler.setFilter(DkFilter_Linear, DkFilter_Linear);
@@ -261,13 +217,17 @@ public:
         {96,96,255,255},
     };
 
+    // Color of each square in the texture, so that squares which keep their color aren't rewritten.
+    // The trail only moves every 4 frames, so most frames don't touch the texture at all.
+    std::array<Pixel, 64> squareColors;
+
     void writeSquare(unsigned idx, Pixel color) {
         auto [block_x, block_y] = pos(idx);
-        for (u32 y = 0; y < DIM/8; ++y) {
-            for (u32 x = 0; x < DIM/8; ++x) {
-                image.write(block_x*DIM/8 + x, block_y*DIM/8 + y, color);
-            }
-        }
+        Pixel& current = squareColors[block_y*8 + block_x];
+        if (memcmp(&current, &color, sizeof(color)) == 0)
+            return;
+        current = color;
+        image.fill(block_x*DIM/8, block_y*DIM/8, DIM/8, DIM/8, color);
     }
 
     unsigned squareIdx = 0;
@@ -2,6 +2,7 @@
 #include "SampleFramework/CShader.h"
 #include "SampleFramework/CApplication.h"
 #include "SampleFramework/CMemPool.h"
+#include "SampleFramework/CAsyncLoader.h"
 
 #include <array>
 #include <optional>
@@ -27,6 +28,8 @@ class Test final : public CApplication
     CShader redShader;
     CShader blueShader;
 
+    CAsyncLoader loader;
+
     dk::UniqueCmdBuf cmdbuf;
 
     CMemPool::Handle framebuffers_mem[NumFramebuffers];
@@ -68,6 +71,13 @@ public:
 
     void createFramebufferResources()
     {
+        // Load the shaders in the background while the rest of the resources are set up
+        CAsyncLoader::Ticket shaderTickets[4];
+        loader.loadShader(shaderTickets[0], vertexShader, *pool_code, "romfs:/shaders/full_tri_vsh.dksh");
+        loader.loadShader(shaderTickets[1], fragmentShader, *pool_code, "romfs:/shaders/sample_3d_fsh.dksh");
+        loader.loadShader(shaderTickets[2], redShader, *pool_code, "romfs:/shaders/red_fsh.dksh");
+        loader.loadShader(shaderTickets[3], blueShader, *pool_code, "romfs:/shaders/blue_fsh.dksh");
+
         dk::ImageLayout layout_framebuffer;
         dk::ImageLayoutMaker{device}
             .setFlags(DkImageFlags_UsageRender | DkImageFlags_UsagePresent | DkImageFlags_HwCompression)
@@ -100,10 +110,8 @@ public:
         emptyImageSet.allocate(*pool_data);
         samplerDescriptorSet.allocate(*pool_data);
 
-        vertexShader.load(*pool_code, "romfs:/shaders/full_tri_vsh.dksh");
-        fragmentShader.load(*pool_code, "romfs:/shaders/sample_3d_fsh.dksh");
-        redShader.load(*pool_code, "romfs:/shaders/red_fsh.dksh");
-        blueShader.load(*pool_code, "romfs:/shaders/blue_fsh.dksh");
+        for (auto& ticket : shaderTickets)
+            ticket.wait();
 
         dk::Sampler sampler;
         sampler.setFilter(DkFilter_Linear, DkFilter_Linear);
@@ -93,8 +93,8 @@ public:
         emptyImageSet.allocate(*pool_data);
         samplerDescriptorSet.allocate(*pool_data);
 
-        vertexShader.load(*pool_code, "romfs:/shaders/full_tri_vsh.dksh");
-        fragmentShader.load(*pool_code, "romfs:/shaders/sample_lod_fsh.dksh");
+        vertexShader.loadShared(*pool_code, "romfs:/shaders/full_tri_vsh.dksh");
+        fragmentShader.loadShared(*pool_code, "romfs:/shaders/sample_lod_fsh.dksh");
 
         dk::Sampler sampler;
         sampler.setFilter(DkFilter_Linear, DkFilter_Linear, DkMipFilter_Nearest);
@@ -2,12 +2,18 @@
 #include "SampleFramework/CShader.h"
 #include "SampleFramework/CApplication.h"
 #include "SampleFramework/CMemPool.h"
+#include "SampleFramework/ImageLayout.h"
+#include "SampleFramework/StreamWrite.h"
 
 #include <array>
 #include <optional>
 
 namespace {
 
+// Each face holds all of its mip levels, padded to a whole tile
+constexpr ImageLayoutInfo TestLayout = ComputeImageLayout({ImageLayoutType_Cubemap, ImageFormatInfo_BC3, 128, 128, 6, 8});
+static_assert(TestLayout.layerStride == 24576, "Cubemap face size doesn't match deko3d");
+
 class Test final : public CApplication
 {
     static constexpr unsigned NumFramebuffers = 2;
@@ -97,9 +103,10 @@ public:
         auto test_block = test_allocation.getMemBlock();
 
         auto pixels = static_cast<u8*>(test_block.getCpuAddr());
-        for (int i = 0; i < 6; ++i) {
-            memset(pixels, i % 2 ? 0x00 : 0xff, 24576);
-            pixels += 24576;
+        for (unsigned i = 0; i < TestLayout.numLayers; ++i) {
+            u8 value = i % 2 ? 0x00 : 0xff;
+            StreamFill(pixels, &value, sizeof(value), TestLayout.layerStride);
+            pixels += TestLayout.layerStride;
         }
 
         dk::Image test_image;
@@ -113,8 +120,8 @@ public:
         imageDescriptorSet.allocate(*pool_data);
         samplerDescriptorSet.allocate(*pool_data);
 
-        vertexShader.load(*pool_code, "romfs:/shaders/full_tri_vsh.dksh");
-        fragmentShader.load(*pool_code, "romfs:/shaders/sample_layer_fsh.dksh");
+        vertexShader.loadShared(*pool_code, "romfs:/shaders/full_tri_vsh.dksh");
+        fragmentShader.loadShared(*pool_code, "romfs:/shaders/sample_layer_fsh.dksh");
 
         dk::Sampler sampler;
         sampler.setFilter(DkFilter_Linear, DkFilter_Linear);
@@ -2,63 +2,13 @@
 #include "SampleFramework/CShader.h"
 #include "SampleFramework/CApplication.h"
 #include "SampleFramework/CMemPool.h"
+#include "SampleFramework/StreamWrite.h"
 
 #include <array>
 #include <optional>
 
 namespace {
 
-constexpr u32 GOB_SIZE_X = 64;
-constexpr u32 GOB_SIZE_Y = 8;
-constexpr u32 GOB_SIZE_Z = 1;
-constexpr u32 GOB_SIZE = GOB_SIZE_X * GOB_SIZE_Y * GOB_SIZE_Z;
-
-constexpr std::size_t GOB_SIZE_X_SHIFT = 6;
-constexpr std::size_t GOB_SIZE_Y_SHIFT = 3;
-constexpr std::size_t GOB_SIZE_Z_SHIFT = 0;
-constexpr std::size_t GOB_SIZE_SHIFT = GOB_SIZE_X_SHIFT + GOB_SIZE_Y_SHIFT + GOB_SIZE_Z_SHIFT;
-
-template <std::size_t N, std::size_t M, u32 Align>
-struct alignas(64) SwizzleTable {
-    static_assert(M * Align == 64, "Swizzle Table does not align to GOB");
-    constexpr SwizzleTable() {
-        for (u32 y = 0; y < N; ++y) {
-            for (u32 x = 0; x < M; ++x) {
-                const u32 x2 = x * Align;
-                values[y][x] = static_cast<u16>(((x2 % 64) / 32) * 256 + ((y % 8) / 2) * 64 +
-                                                ((x2 % 32) / 16) * 32 + (y % 2) * 16 + (x2 % 16));
-            }
-        }
-    }
-    const std::array<u16, M>& operator[](std::size_t index) const {
-        return values[index];
-    }
-    std::array<std::array<u16, M>, N> values{};
-};
-constexpr auto LEGACY_SWIZZLE_TABLE = SwizzleTable<GOB_SIZE_X, GOB_SIZE_X, GOB_SIZE_Z>();
-
-size_t Swizzle(u32 width, u32 bytes_per_pixel, u32 block_height, u32 origin_x, u32 origin_y) {
-    const u32 stride = width * bytes_per_pixel;
-    const u32 gobs_in_x = (stride + GOB_SIZE_X - 1) / GOB_SIZE_X;
-    const u32 block_size = gobs_in_x << (GOB_SIZE_SHIFT + block_height);
-
-    const u32 block_height_mask = (1U << block_height) - 1;
-    const u32 x_shift = static_cast<u32>(GOB_SIZE_SHIFT) + block_height;
-
-    const u32 dst_y = origin_y;
-    const auto& table = LEGACY_SWIZZLE_TABLE[dst_y % GOB_SIZE_Y];
-
-    const u32 block_y = dst_y >> GOB_SIZE_Y_SHIFT;
-    const u32 dst_offset_y =
-         (block_y >> block_height) * block_size +
-        ((block_y & block_height_mask) << GOB_SIZE_SHIFT);
-        
-    const u32 dst_x = origin_x * bytes_per_pixel;
-    const u32 offset_x = (dst_x >> GOB_SIZE_X_SHIFT) << x_shift;
-
-    return dst_offset_y + offset_x + table[dst_x % GOB_SIZE_X];
-}
-
 class Test final : public CApplication
 {
     static constexpr unsigned NumFramebuffers = 2;
@@ -93,14 +43,6 @@ class Test final : public CApplication
     };
     struct Image {
         u8* data;
-        u32 width;
-        u32 block_height;
-
-        void write(int x, int y, Pixel color)
-        {
-            size_t o = Swizzle(width, 4, block_height, x, y);
-            memcpy(data + o, &color, sizeof(color));
-        }
     };
     Image image;
 
@@ -150,12 +92,8 @@ public:
         auto test_block = test_allocation.getMemBlock();
 
         image.data = static_cast<u8*>(test_block.getCpuAddr());
-        for (int x = 0; x < 32*32*32; ++x) {
-            image.data[x*4+0] = 255;
-            image.data[x*4+1] = 255;
-            image.data[x*4+2] = 255;
-            image.data[x*4+3] = 255;
-        }
+        Pixel white{255,255,255,255};
+        StreamFill(image.data, &white, sizeof(white), 32*32*32*sizeof(Pixel));
 
         dk::Image test_image;
         test_image.initialize(layout_test, test_block, test_allocation.getOffset());
@@ -163,8 +101,8 @@ public:
         imageDescriptorSet.allocate(*pool_data);
         samplerDescriptorSet.allocate(*pool_data);
 
-        vertexShader.load(*pool_code, "romfs:/shaders/full_tri_vsh.dksh");
-        fragmentShader.load(*pool_code, "romfs:/shaders/sample_3d_fsh.dksh");
+        vertexShader.loadShared(*pool_code, "romfs:/shaders/full_tri_vsh.dksh");
+        fragmentShader.loadShared(*pool_code, "romfs:/shaders/sample_3d_fsh.dksh");
 
         dk::Sampler sampler;
         sampler.setFilter(DkFilter_Linear, DkFilter_Linear);
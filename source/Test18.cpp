@@ -100,10 +100,10 @@ public:
         emptyImageSet.allocate(*pool_data);
         samplerDescriptorSet.allocate(*pool_data);
 
-        vertexShader.load(*pool_code, "romfs:/shaders/full_tri_vsh.dksh");
-        fragmentShader.load(*pool_code, "romfs:/shaders/sample_3d_fsh.dksh");
-        redShader.load(*pool_code, "romfs:/shaders/red_fsh.dksh");
-        blueShader.load(*pool_code, "romfs:/shaders/blue_fsh.dksh");
+        vertexShader.loadShared(*pool_code, "romfs:/shaders/full_tri_vsh.dksh");
+        fragmentShader.loadShared(*pool_code, "romfs:/shaders/sample_3d_fsh.dksh");
+        redShader.loadShared(*pool_code, "romfs:/shaders/red_fsh.dksh");
+        blueShader.loadShared(*pool_code, "romfs:/shaders/blue_fsh.dksh");
 
         dk::Sampler sampler;
         sampler.setFilter(DkFilter_Linear, DkFilter_Linear);
@@ -0,0 +1,228 @@
+#include "SampleFramework/CDescriptorSet.h"
+#include "SampleFramework/CDescriptorCache.h"
+#include "SampleFramework/CDescriptorHeap.h"
+#include "SampleFramework/CApplication.h"
+#include "SampleFramework/CMemPool.h"
+#include "SampleFramework/StreamWrite.h"
+
+#include <array>
+#include <optional>
+
+namespace {
+
+constexpr unsigned NumDescriptors = 4096;
+constexpr unsigned NumIterations = 16;
+
+// The cache is fed NumDescriptors bindings that only use this many different descriptors, as when many
+// draws share a handful of textures
+constexpr unsigned NumDistinct = 64;
+
+// Unused command memory is filled with this, so that the amount written by a path can be read back
+constexpr uint32_t CmdFillPattern = 0xCDCDCDCD;
+
+class Test final : public CApplication
+{
+    static constexpr unsigned CmdSize = 1*1024*1024;
+
+    dk::UniqueDevice device;
+    dk::UniqueQueue queue;
+
+    std::optional<CMemPool> pool_data;
+
+    dk::UniqueCmdBuf cmdbuf;
+    CMemPool::Handle cmdmem;
+
+    CDescriptorSet<NumDescriptors> imageDescriptorSet;
+    CDescriptorHeap<2> imageDescriptorHeap;
+    CDescriptorCache<NumDistinct> imageDescriptorCache;
+
+    std::array<dk::ImageDescriptor, NumDescriptors> descriptors;
+
+public:
+    Test()
+    {
+        consoleInit(NULL);
+
+        device = dk::DeviceMaker{}.create();
+
+        queue = dk::QueueMaker{device}.setFlags(DkQueueFlags_Graphics).create();
+
+        pool_data.emplace(device, DkMemBlockFlags_CpuUncached | DkMemBlockFlags_GpuCached, 4*1024*1024);
+
+        cmdbuf = dk::CmdBufMaker{device}.create();
+        cmdmem = pool_data->allocate(CmdSize);
+
+        imageDescriptorSet.allocate(*pool_data);
+        imageDescriptorHeap.allocate(*pool_data, NumDescriptors);
+        imageDescriptorCache.allocate(*pool_data);
+
+        // The contents don't matter, only the amount of data being moved around
+        memset(descriptors.data(), 0, sizeof(descriptors));
+
+        printf("Updating %u descriptors (%u bytes), %u iterations\n\n", NumDescriptors,
+            unsigned(sizeof(descriptors)), NumIterations);
+
+        u64 pushTicks = 0, directTicks = 0, heapTicks = 0, cacheTicks = 0;
+        uint32_t pushBytes = 0, directBytes = 0, heapBytes = 0, cacheBytes = 0;
+        unsigned heapFailed = 0, cacheHits = 0, cacheMisses = 0;
+        for (unsigned i = 0; i < NumIterations; i ++)
+        {
+            // Command memory usage is the same every iteration, so it is only measured on the first one
+            bool track = i == 0;
+            pushTicks += measure(false, track, pushBytes);
+            directTicks += measure(true, track, directBytes);
+            heapTicks += measureHeap(heapFailed, track, heapBytes);
+            cacheTicks += measureCache(cacheHits, cacheMisses, track, cacheBytes);
+        }
+
+        printf("pushData:     %8lu us/update, %7u bytes of command memory\n",
+            armTicksToNs(pushTicks / NumIterations) / 1000, pushBytes);
+        printf("direct write: %8lu us/update, %7u bytes of command memory\n",
+            armTicksToNs(directTicks / NumIterations) / 1000, directBytes);
+        printf("heap slots:   %8lu us/update, %7u bytes of command memory\n",
+            armTicksToNs(heapTicks / NumIterations) / 1000, heapBytes);
+        if (heapFailed)
+            printf("  %u heap slot allocations failed!\n", heapFailed);
+        printf("dedup cache:  %8lu us/update, %7u bytes of command memory\n",
+            armTicksToNs(cacheTicks / NumIterations) / 1000, cacheBytes);
+        printf("  %u distinct descriptors: %u hits, %u misses per update\n", NumDistinct,
+            cacheHits / NumIterations, cacheMisses / NumIterations);
+        printf("\nPress PLUS(+) to exit\n");
+    }
+
+    ~Test()
+    {
+        queue.waitIdle();
+        cmdbuf.clear();
+        cmdmem.destroy();
+        consoleExit(NULL);
+    }
+
+    void beginCommands(bool track)
+    {
+        cmdbuf.clear();
+        if (track)
+            StreamFill(cmdmem.getCpuAddr(), &CmdFillPattern, sizeof(CmdFillPattern), cmdmem.getSize());
+        cmdbuf.addMemory(cmdmem.getMemBlock(), cmdmem.getOffset(), cmdmem.getSize());
+    }
+
+    // Command memory is used from the start, so everything up to the last word not holding the
+    // fill pattern was written by the commands just recorded
+    uint32_t getCommandBytes() const
+    {
+        auto words = static_cast<uint32_t const*>(cmdmem.getCpuAddr());
+        uint32_t n = cmdmem.getSize() / sizeof(uint32_t);
+        while (n && words[n - 1] == CmdFillPattern)
+            n --;
+        return n * sizeof(uint32_t);
+    }
+
+    // Measures the time taken from the start of the update until the GPU is able to see it
+    u64 measure(bool direct, bool track, uint32_t& cmdBytes)
+    {
+        beginCommands(track);
+
+        u64 start = armGetSystemTick();
+        if (direct)
+        {
+            imageDescriptorSet.write(0, descriptors);
+            imageDescriptorSet.invalidate(cmdbuf);
+        }
+        else
+            imageDescriptorSet.update(cmdbuf, 0, descriptors);
+
+        queue.submitCommands(cmdbuf.finishList());
+        queue.waitIdle();
+        u64 ticks = armGetSystemTick() - start;
+
+        if (track)
+            cmdBytes = getCommandBytes();
+        return ticks;
+    }
+
+    // Same as the pushData path, but every descriptor goes through a slot of its own that is handed back at
+    // the end of the frame, so that the next frame can only get it back once the GPU is done with this one
+    u64 measureHeap(unsigned& failed, bool track, uint32_t& cmdBytes)
+    {
+        beginCommands(track);
+
+        u64 start = armGetSystemTick();
+        imageDescriptorHeap.beginFrame();
+        for (unsigned i = 0; i < NumDescriptors; i ++)
+        {
+            uint32_t id = imageDescriptorHeap.alloc();
+            if (id == imageDescriptorHeap.InvalidId)
+            {
+                failed ++;
+                continue;
+            }
+            imageDescriptorHeap.update(cmdbuf, id, descriptors[i]);
+            imageDescriptorHeap.release(id);
+        }
+        imageDescriptorHeap.endFrame(cmdbuf);
+
+        queue.submitCommands(cmdbuf.finishList());
+        queue.waitIdle();
+        u64 ticks = armGetSystemTick() - start;
+
+        if (track)
+            cmdBytes = getCommandBytes();
+        return ticks;
+    }
+
+    // Binds every descriptor through the cache, which only records an update the first time a descriptor
+    // is seen. Slots are handed back once the GPU is done, so each iteration starts with an empty cache.
+    u64 measureCache(unsigned& hits, unsigned& misses, bool track, uint32_t& cmdBytes)
+    {
+        std::array<uint32_t, NumDescriptors> ids;
+
+        beginCommands(track);
+
+        u64 start = armGetSystemTick();
+        for (unsigned i = 0; i < NumDescriptors; i ++)
+        {
+            dk::ImageDescriptor descriptor;
+            memset(&descriptor, 0, sizeof(descriptor));
+            uint32_t key = i % NumDistinct;
+            memcpy(&descriptor, &key, sizeof(key));
+
+            ids[i] = imageDescriptorCache.acquire(cmdbuf, descriptor);
+            if (ids[i] == imageDescriptorCache.InvalidId)
+                continue;
+            if (imageDescriptorCache.getRefCount(ids[i]) > 1)
+                hits ++;
+            else
+                misses ++;
+        }
+
+        queue.submitCommands(cmdbuf.finishList());
+        queue.waitIdle();
+        u64 ticks = armGetSystemTick() - start;
+
+        if (track)
+            cmdBytes = getCommandBytes();
+
+        for (uint32_t id : ids)
+            if (id != imageDescriptorCache.InvalidId)
+                imageDescriptorCache.release(id);
+        return ticks;
+    }
+
+    bool onFrame(u64 ns) override
+    {
+        hidScanInput();
+        if (hidKeysDown(CONTROLLER_P1_AUTO) & KEY_PLUS) {
+            return false;
+        }
+        consoleUpdate(NULL);
+        return true;
+    }
+};
+
+} // Anonymous namespace
+
+void Test26()
+{
+    Test app;
+    app.run();
+}
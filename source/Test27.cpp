@@ -0,0 +1,190 @@
+#include "SampleFramework/CShader.h"
+#include "SampleFramework/CShaderArchive.h"
+#include "SampleFramework/CApplication.h"
+#include "SampleFramework/CMemPool.h"
+
+#include <array>
+#include <optional>
+
+namespace {
+
+constexpr std::array ShaderNames =
+{
+    "basic_deferred_fsh", "basic_lighting_fsh", "basic_vsh", "blue_fsh", "color_fsh",
+    "composition_fsh", "composition_vsh", "full_tri_vsh", "gradient_fsh", "red_fsh",
+    "sample_3d_fsh", "sample_buffer_fsh", "sample_cube_fsh", "sample_fsh", "sample_layer_fsh",
+    "sample_lod_fsh", "shadow_fsh", "sinewave", "tess_simple_tcsh", "tess_simple_tesh",
+    "texture_fsh", "transform_normal_vsh", "transform_vsh",
+};
+
+constexpr std::array ShaderPaths =
+{
+    "romfs:/shaders/basic_deferred_fsh.dksh",
+    "romfs:/shaders/basic_lighting_fsh.dksh",
+    "romfs:/shaders/basic_vsh.dksh",
+    "romfs:/shaders/blue_fsh.dksh",
+    "romfs:/shaders/color_fsh.dksh",
+    "romfs:/shaders/composition_fsh.dksh",
+    "romfs:/shaders/composition_vsh.dksh",
+    "romfs:/shaders/full_tri_vsh.dksh",
+    "romfs:/shaders/gradient_fsh.dksh",
+    "romfs:/shaders/red_fsh.dksh",
+    "romfs:/shaders/sample_3d_fsh.dksh",
+    "romfs:/shaders/sample_buffer_fsh.dksh",
+    "romfs:/shaders/sample_cube_fsh.dksh",
+    "romfs:/shaders/sample_fsh.dksh",
+    "romfs:/shaders/sample_layer_fsh.dksh",
+    "romfs:/shaders/sample_lod_fsh.dksh",
+    "romfs:/shaders/shadow_fsh.dksh",
+    "romfs:/shaders/sinewave.dksh",
+    "romfs:/shaders/tess_simple_tcsh.dksh",
+    "romfs:/shaders/tess_simple_tesh.dksh",
+    "romfs:/shaders/texture_fsh.dksh",
+    "romfs:/shaders/transform_normal_vsh.dksh",
+    "romfs:/shaders/transform_vsh.dksh",
+};
+
+constexpr const char* SharedPath = "romfs:/shaders/full_tri_vsh.dksh";
+
+// One pipeline, either as one file per stage or as a single file merged by dkshmerge
+constexpr std::array PipelineStagePaths = { "romfs:/shaders/full_tri_vsh.dksh", "romfs:/shaders/sample_fsh.dksh" };
+constexpr const char* PipelinePath = "romfs:/pipelines/full_tri_sample.dksh";
+constexpr unsigned NumPipelines = ShaderPaths.size() / PipelineStagePaths.size();
+
+constexpr unsigned NumIterations = 32;
+
+class Test final : public CApplication
+{
+    dk::UniqueDevice device;
+
+    std::optional<CMemPool> pool_code;
+
+    std::array<CShader, ShaderPaths.size()> shaders;
+
+    CShaderArchive archive;
+    std::array<dk::Shader, ShaderNames.size()> archiveShaders;
+
+public:
+    Test()
+    {
+        consoleInit(NULL);
+
+        device = dk::DeviceMaker{}.create();
+
+        pool_code.emplace(device, DkMemBlockFlags_CpuUncached | DkMemBlockFlags_GpuCached | DkMemBlockFlags_Code, 128*1024);
+
+        printf("Loading %u shaders, %u iterations\n\n", unsigned(ShaderPaths.size()), NumIterations);
+
+        u64 ticks = 0;
+        unsigned failed = 0;
+        for (unsigned i = 0; i < NumIterations; i ++)
+        {
+            u64 start = armGetSystemTick();
+            for (unsigned j = 0; j < ShaderPaths.size(); j ++)
+                if (!shaders[j].load(*pool_code, ShaderPaths[j]))
+                    failed ++;
+            ticks += armGetSystemTick() - start;
+        }
+        report("CShader::load", ticks, failed);
+
+        // Loading the same file into every shader is where sharing pays off: plain loads read and upload it
+        // every time, while shared loads only read it once and upload it once per pool
+        ticks = 0;
+        failed = 0;
+        for (unsigned i = 0; i < NumIterations; i ++)
+        {
+            u64 start = armGetSystemTick();
+            for (unsigned j = 0; j < shaders.size(); j ++)
+                if (!shaders[j].load(*pool_code, SharedPath))
+                    failed ++;
+            ticks += armGetSystemTick() - start;
+        }
+        report("CShader::load, same", ticks, failed);
+
+        ticks = 0;
+        failed = 0;
+        for (unsigned i = 0; i < NumIterations; i ++)
+        {
+            u64 start = armGetSystemTick();
+            for (unsigned j = 0; j < shaders.size(); j ++)
+                if (!shaders[j].loadShared(*pool_code, SharedPath))
+                    failed ++;
+            ticks += armGetSystemTick() - start;
+        }
+        report("CShader::loadShared", ticks, failed);
+
+        ticks = 0;
+        failed = 0;
+        for (unsigned i = 0; i < NumIterations; i ++)
+        {
+            u64 start = armGetSystemTick();
+            if (!archive.load(*pool_code, "romfs:/shaders.dksa"))
+                failed ++;
+            for (unsigned j = 0; j < ShaderNames.size(); j ++)
+                if (!archive.initialize(ShaderNames[j], archiveShaders[j]))
+                    failed ++;
+            ticks += armGetSystemTick() - start;
+        }
+        report("CShaderArchive", ticks, failed);
+
+        printf("\nLoading %u pipelines of %u stages\n\n", NumPipelines, unsigned(PipelineStagePaths.size()));
+
+        ticks = 0;
+        failed = 0;
+        for (unsigned i = 0; i < NumIterations; i ++)
+        {
+            u64 start = armGetSystemTick();
+            for (unsigned j = 0; j < NumPipelines; j ++)
+                for (unsigned k = 0; k < PipelineStagePaths.size(); k ++)
+                    if (!shaders[j*PipelineStagePaths.size() + k].load(*pool_code, PipelineStagePaths[k]))
+                        failed ++;
+            ticks += armGetSystemTick() - start;
+        }
+        report("CShader::load, stages", ticks, failed, NumPipelines, "pipeline");
+
+        ticks = 0;
+        failed = 0;
+        for (unsigned i = 0; i < NumIterations; i ++)
+        {
+            u64 start = armGetSystemTick();
+            for (unsigned j = 0; j < NumPipelines; j ++)
+                if (!shaders[j].load(*pool_code, PipelinePath) || !shaders[j].find("vert") || !shaders[j].find("frag"))
+                    failed ++;
+            ticks += armGetSystemTick() - start;
+        }
+        report("CShader::load, merged", ticks, failed, NumPipelines, "pipeline");
+
+        printf("\nPress PLUS(+) to exit\n");
+    }
+
+    ~Test()
+    {
+        consoleExit(NULL);
+    }
+
+    static void report(const char* name, u64 ticks, unsigned failed, unsigned count = ShaderPaths.size(), const char* unit = "shader")
+    {
+        u64 ns = armTicksToNs(ticks / NumIterations);
+        printf("%-22s %6lu us for all %ss, %5lu us/%s\n", name, ns / 1000, unit, ns / 1000 / count, unit);
+        if (failed)
+            printf("  %u loads failed!\n", failed);
+    }
+
+    bool onFrame(u64 ns) override
+    {
+        hidScanInput();
+        if (hidKeysDown(CONTROLLER_P1_AUTO) & KEY_PLUS) {
+            return false;
+        }
+        consoleUpdate(NULL);
+        return true;
+    }
+};
+
+} // Anonymous namespace
+
+void Test27()
+{
+    Test app;
+    app.run();
+}
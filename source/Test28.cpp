@@ -0,0 +1,120 @@
+#include "SampleFramework/CStagingRing.h"
+#include "SampleFramework/CApplication.h"
+#include "SampleFramework/CMemPool.h"
+
+#include <array>
+#include <optional>
+
+namespace {
+
+constexpr uint32_t RingSize = 1*1024*1024;
+constexpr uint32_t TotalSize = 16*1024*1024;
+constexpr std::array UploadSizes = { 4*1024U, 64*1024U, 1024*1024U, 4*1024*1024U };
+
+class Test final : public CApplication
+{
+    dk::UniqueDevice device;
+    dk::UniqueQueue queue;
+
+    std::optional<CMemPool> pool_data;
+    std::optional<CMemPool> pool_dest;
+
+    CStagingRing ring;
+
+    CMemPool::Handle dest;
+    void* source;
+
+public:
+    Test()
+    {
+        consoleInit(NULL);
+
+        device = dk::DeviceMaker{}.create();
+
+        queue = dk::QueueMaker{device}.setFlags(DkQueueFlags_Graphics).create();
+
+        pool_data.emplace(device, DkMemBlockFlags_CpuUncached | DkMemBlockFlags_GpuCached, 16*1024*1024);
+        pool_dest.emplace(device, DkMemBlockFlags_GpuCached, TotalSize);
+
+        ring.allocate(device, queue, *pool_data, RingSize);
+        dest = pool_dest->allocate(TotalSize);
+
+        source = ::malloc(TotalSize);
+        memset(source, 0x55, TotalSize);
+
+        printf("Uploading %u MiB per run, %u KiB staging ring\n\n", TotalSize >> 20, RingSize >> 10);
+
+        for (uint32_t size : UploadSizes)
+        {
+            u64 ringTicks = measureRing(size);
+            u64 scratchTicks = measureScratch(size);
+            printf("%5u KiB uploads: ring %7.1f MB/s, scratch+waitIdle %7.1f MB/s\n", size >> 10,
+                mbPerSecond(ringTicks), mbPerSecond(scratchTicks));
+        }
+
+        printf("\nUploads larger than the ring are split across wrap-around\n");
+        printf("\nPress PLUS(+) to exit\n");
+    }
+
+    ~Test()
+    {
+        queue.waitIdle();
+        ::free(source);
+        dest.destroy();
+        consoleExit(NULL);
+    }
+
+    static double mbPerSecond(u64 ticks)
+    {
+        return double(TotalSize) * 1000.0 / armTicksToNs(ticks);
+    }
+
+    u64 measureRing(uint32_t size)
+    {
+        u64 start = armGetSystemTick();
+        for (uint32_t offset = 0; offset < TotalSize; offset += size)
+            ring.uploadBuffer(dest.getGpuAddr() + offset, (u8*)source + offset, size);
+        ring.wait();
+        return armGetSystemTick() - start;
+    }
+
+    // What a typical one-off upload does: allocate staging and command memory, copy, submit and wait
+    u64 measureScratch(uint32_t size)
+    {
+        u64 start = armGetSystemTick();
+        for (uint32_t offset = 0; offset < TotalSize; offset += size)
+        {
+            CMemPool::Handle tempmem = pool_data->allocate(size, DK_MEMBLOCK_ALIGNMENT);
+            CMemPool::Handle tempcmdmem = pool_data->allocate(DK_MEMBLOCK_ALIGNMENT);
+            memcpy(tempmem.getCpuAddr(), (u8*)source + offset, size);
+
+            dk::UniqueCmdBuf tempcmdbuf = dk::CmdBufMaker{device}.create();
+            tempcmdbuf.addMemory(tempcmdmem.getMemBlock(), tempcmdmem.getOffset(), tempcmdmem.getSize());
+            tempcmdbuf.copyBuffer(tempmem.getGpuAddr(), dest.getGpuAddr() + offset, size);
+            queue.submitCommands(tempcmdbuf.finishList());
+            queue.waitIdle();
+
+            tempcmdmem.destroy();
+            tempmem.destroy();
+        }
+        return armGetSystemTick() - start;
+    }
+
+    bool onFrame(u64 ns) override
+    {
+        hidScanInput();
+        if (hidKeysDown(CONTROLLER_P1_AUTO) & KEY_PLUS) {
+            return false;
+        }
+        consoleUpdate(NULL);
+        return true;
+    }
+};
+
+} // Anonymous namespace
+
+void Test28()
+{
+    Test app;
+    app.run();
+}
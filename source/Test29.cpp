@@ -0,0 +1,168 @@
+#include "SampleFramework/CApplication.h"
+#include "SampleFramework/CMemPool.h"
+#include "SampleFramework/StreamWrite.h"
+#include "SampleFramework/Swizzle.h"
+
+#include <arm_neon.h>
+
+#include <array>
+#include <optional>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t ImageDim = 1024;
+constexpr uint32_t BytesPerPixel = 4;
+constexpr uint32_t ImageSize = ImageDim*ImageDim*BytesPerPixel;
+constexpr unsigned NumIterations = 8;
+
+// All of these write the same 4 MiB image into CPU-uncached memory, the way the raw write tests do
+class Test final : public CApplication
+{
+    struct Pixel {
+        u8 r, g, b, a;
+    };
+
+    dk::UniqueDevice device;
+
+    std::optional<CMemPool> pool_images;
+
+    CMemPool::Handle dest;
+    u8* data;
+
+    SwizzleSurface surf{ImageDim, ImageDim, BytesPerPixel, 4};
+    std::vector<Pixel> source;
+
+public:
+    Test()
+    {
+        consoleInit(NULL);
+
+        device = dk::DeviceMaker{}.create();
+
+        pool_images.emplace(device, DkMemBlockFlags_CpuUncached | DkMemBlockFlags_GpuCached | DkMemBlockFlags_Image, 16*1024*1024);
+
+        dest = pool_images->allocate(surf.getSize(), DK_MEMBLOCK_ALIGNMENT);
+        data = static_cast<u8*>(dest.getCpuAddr());
+
+        source.resize(ImageDim*ImageDim);
+        for (uint32_t i = 0; i < source.size(); i ++)
+            source[i] = Pixel{u8(i), u8(i >> 8), u8(i >> 16), 255};
+
+        printf("Writing a %ux%u RGBA8 image (%u KiB) to uncached memory, %u iterations\n\n",
+            ImageDim, ImageDim, ImageSize >> 10, NumIterations);
+
+        printf("Pitch linear:\n");
+        report("per-pixel fill", measure([this] { fillPerPixel(); }));
+        report("memset", measure([this] { memset(data, 0x60, ImageSize); }));
+        report("16-byte stores fill", measure([this] { fillVector(); }));
+        report("StreamFill", measure([this] { fillStream(); }));
+        report("per-pixel copy", measure([this] { copyPerPixel(); }));
+        report("memcpy", measure([this] { memcpy(data, source.data(), ImageSize); }));
+        report("16-byte stores copy", measure([this] { copyVector(); }));
+        report("StreamCopy", measure([this] { StreamCopy(data, source.data(), ImageSize); }));
+
+        printf("\nBlock linear:\n");
+        report("per-pixel Swizzle()", measure([this] { swizzlePerPixel(); }));
+        report("SwizzleImage", measure([this] { SwizzleImage(surf, data, source.data(), ImageDim*BytesPerPixel); }));
+
+        printf("\nPress PLUS(+) to exit\n");
+    }
+
+    ~Test()
+    {
+        dest.destroy();
+        consoleExit(NULL);
+    }
+
+    template <typename Func>
+    static u64 measure(Func&& func)
+    {
+        u64 start = armGetSystemTick();
+        for (unsigned i = 0; i < NumIterations; i ++)
+            func();
+        return (armGetSystemTick() - start) / NumIterations;
+    }
+
+    static void report(const char* name, u64 ticks)
+    {
+        u64 ns = armTicksToNs(ticks);
+        printf("  %-20s %7lu us, %7.1f MB/s\n", name, ns / 1000, double(ImageSize) * 1000.0 / ns);
+    }
+
+    // What the raw write tests used to do
+    void fillPerPixel()
+    {
+        Pixel color{96,96,96,255};
+        for (uint32_t y = 0; y < ImageDim; y ++)
+            for (uint32_t x = 0; x < ImageDim; x ++)
+                memcpy(data + (y*ImageDim + x)*BytesPerPixel, &color, sizeof(color));
+    }
+
+    // Same runs of 16-byte stores as StreamFill and StreamCopy, but plain stores instead of stnp
+    void fillVector()
+    {
+        u32 color = 0xFF606060;
+        uint8x16_t v = vreinterpretq_u8_u32(vdupq_n_u32(color));
+        for (uint32_t i = 0; i < ImageSize; i += 64)
+        {
+            vst1q_u8(data + i +  0, v);
+            vst1q_u8(data + i + 16, v);
+            vst1q_u8(data + i + 32, v);
+            vst1q_u8(data + i + 48, v);
+        }
+    }
+
+    void copyVector()
+    {
+        auto src = reinterpret_cast<u8 const*>(source.data());
+        for (uint32_t i = 0; i < ImageSize; i += 64)
+        {
+            uint8x16_t v0 = vld1q_u8(src + i +  0);
+            uint8x16_t v1 = vld1q_u8(src + i + 16);
+            uint8x16_t v2 = vld1q_u8(src + i + 32);
+            uint8x16_t v3 = vld1q_u8(src + i + 48);
+            vst1q_u8(data + i +  0, v0);
+            vst1q_u8(data + i + 16, v1);
+            vst1q_u8(data + i + 32, v2);
+            vst1q_u8(data + i + 48, v3);
+        }
+    }
+
+    void fillStream()
+    {
+        Pixel color{96,96,96,255};
+        StreamFill(data, &color, sizeof(color), ImageSize);
+    }
+
+    void copyPerPixel()
+    {
+        for (uint32_t i = 0; i < source.size(); i ++)
+            memcpy(data + i*BytesPerPixel, &source[i], sizeof(Pixel));
+    }
+
+    void swizzlePerPixel()
+    {
+        for (uint32_t y = 0; y < ImageDim; y ++)
+            for (uint32_t x = 0; x < ImageDim; x ++)
+                memcpy(data + Swizzle(ImageDim, BytesPerPixel, 4, x, y), &source[y*ImageDim + x], sizeof(Pixel));
+    }
+
+    bool onFrame(u64 ns) override
+    {
+        hidScanInput();
+        if (hidKeysDown(CONTROLLER_P1_AUTO) & KEY_PLUS) {
+            return false;
+        }
+        consoleUpdate(NULL);
+        return true;
+    }
+};
+
+} // Anonymous namespace
+
+void Test29()
+{
+    Test app;
+    app.run();
+}
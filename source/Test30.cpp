@@ -0,0 +1,233 @@
+#include "SampleFramework/CApplication.h"
+#include "SampleFramework/CMemPool.h"
+#include "SampleFramework/ImageLayout.h"
+#include "SampleFramework/StreamWrite.h"
+
+#include <array>
+#include <optional>
+
+namespace {
+
+struct LayoutCase
+{
+    const char* name;
+    DkImageFormat format;
+    ImageLayoutParams params;
+};
+
+// Images whose layouts are compared with deko3d; the values captured here go into the imagelayout host tool
+const std::array LayoutCases =
+{
+    LayoutCase{ "Test10 BC3 cubemap",        DkImageFormat_RGBA_BC3,      { ImageLayoutType_Cubemap, ImageFormatInfo_BC3, 128, 128, 6, 8 } },
+    LayoutCase{ "720p RGBA8 framebuffer",    DkImageFormat_RGBA8_Unorm,   { ImageLayoutType_2D, ImageFormatInfo_RGBA8, 1280, 720 } },
+    LayoutCase{ "Test12 RGBA8 3D",           DkImageFormat_RGBA8_Unorm,   { ImageLayoutType_3D, ImageFormatInfo_RGBA8, 32, 32, 32 } },
+    LayoutCase{ "RGBA8 3D mips",             DkImageFormat_RGBA8_Unorm,   { ImageLayoutType_3D, ImageFormatInfo_RGBA8, 64, 64, 8, 4 } },
+    LayoutCase{ "RGBA8 1D",                  DkImageFormat_RGBA8_Unorm,   { ImageLayoutType_1D, ImageFormatInfo_RGBA8, 1000 } },
+    LayoutCase{ "RGBA8 1D array mips",       DkImageFormat_RGBA8_Unorm,   { ImageLayoutType_1DArray, ImageFormatInfo_RGBA8, 256, 1, 4, 3 } },
+    LayoutCase{ "RGBA8 2D array mips",       DkImageFormat_RGBA8_Unorm,   { ImageLayoutType_2DArray, ImageFormatInfo_RGBA8, 100, 60, 3, 2 } },
+    LayoutCase{ "BC1 cubemap array mips",    DkImageFormat_RGB_BC1,       { ImageLayoutType_CubemapArray, ImageFormatInfo_BC1, 64, 64, 12, 7 } },
+    LayoutCase{ "BC1 NPOT mips",             DkImageFormat_RGB_BC1,       { ImageLayoutType_2D, ImageFormatInfo_BC1, 100, 100, 1, 3 } },
+    LayoutCase{ "BC3 NPOT mips",             DkImageFormat_RGBA_BC3,      { ImageLayoutType_2D, ImageFormatInfo_BC3, 132, 132, 1, 2 } },
+    LayoutCase{ "ASTC 8x8 NPOT mips",        DkImageFormat_RGBA_ASTC_8x8, { ImageLayoutType_2D, ImageFormatInfo_ASTC(8, 8), 100, 100, 1, 2 } },
+    LayoutCase{ "RGBA8 buffer",              DkImageFormat_RGBA8_Unorm,   { ImageLayoutType_Buffer, ImageFormatInfo_RGBA8, 1000 } },
+    LayoutCase{ "Test02 pitch linear RGBA8", DkImageFormat_RGBA8_Unorm,   { ImageLayoutType_2D, ImageFormatInfo_RGBA8, 512, 512, 1, 1, IMAGE_AUTO_TILE_SIZE, 2048 } },
+    LayoutCase{ "Test03 custom tile RGBA8",  DkImageFormat_RGBA8_Unorm,   { ImageLayoutType_2D, ImageFormatInfo_RGBA8, 4096, 4096, 1, 1, DkTileSize_SixteenGobs } },
+};
+
+constexpr uint32_t MaxProbedLevels = 8;
+
+constexpr DkImageType ImageTypes[] =
+{
+    DkImageType_1D,
+    DkImageType_2D,
+    DkImageType_3D,
+    DkImageType_1DArray,
+    DkImageType_2DArray,
+    DkImageType_Cubemap,
+    DkImageType_CubemapArray,
+    DkImageType_Buffer,
+};
+
+class Test final : public CApplication
+{
+    static constexpr unsigned CmdSize = 0x1000;
+
+    dk::UniqueDevice device;
+    dk::UniqueQueue queue;
+
+    std::optional<CMemPool> pool_probe;
+    std::optional<CMemPool> pool_data;
+
+    dk::UniqueCmdBuf cmdbuf;
+    CMemPool::Handle cmdmem;
+    CMemPool::Handle marker;
+
+    // What deko3d actually did with an image, found by probing its memory
+    struct Probed
+    {
+        uint64_t levelOffsets[MaxProbedLevels];
+        uint64_t layerStride;
+    };
+
+public:
+    Test()
+    {
+        consoleInit(NULL);
+
+        device = dk::DeviceMaker{}.create();
+        queue = dk::QueueMaker{device}.setFlags(DkQueueFlags_Graphics).create();
+
+        pool_probe.emplace(device, DkMemBlockFlags_CpuUncached | DkMemBlockFlags_GpuCached | DkMemBlockFlags_Image, 16*1024*1024);
+        pool_data.emplace(device, DkMemBlockFlags_CpuUncached | DkMemBlockFlags_GpuCached, 1*1024*1024);
+
+        cmdbuf = dk::CmdBufMaker{device}.create();
+        cmdmem = pool_data->allocate(CmdSize);
+
+        // One compression block of the largest format, with every byte set
+        const u8 ones = 0xFF;
+        marker = pool_data->allocate(16, DK_IMAGE_LINEAR_STRIDE_ALIGNMENT);
+        StreamFill(marker.getCpuAddr(), &ones, sizeof(ones), marker.getSize());
+
+        printf("Comparing ComputeImageLayout with dk::ImageLayout\n");
+        printf("Mip offsets and layer strides are probed with GPU copies\n\n");
+        printf("%-26s %9s %9s %6s %6s %6s %6s\n", "", "size", "expected", "align", "expect", "mips", "layers");
+
+        std::array<Probed, LayoutCases.size()> probed;
+        unsigned mismatches = 0;
+        for (unsigned i = 0; i < LayoutCases.size(); i ++)
+        {
+            auto const& c = LayoutCases[i];
+            dk::ImageLayout layout;
+            initLayout(c, layout);
+
+            ImageLayoutInfo info = ComputeImageLayout(c.params);
+            probe(c, info, layout, probed[i]);
+
+            bool levelsOk = true;
+            for (uint32_t level = 0; level < info.numLevels && level < MaxProbedLevels; level ++)
+                levelsOk = levelsOk && info.getLevelOffset(level) == probed[i].levelOffsets[level];
+            bool layersOk = info.layerStride == probed[i].layerStride;
+
+            bool ok = info.size == layout.getSize() && info.alignment == layout.getAlignment() && levelsOk && layersOk;
+            if (!ok)
+                mismatches ++;
+
+            printf("%-26s %9lu %9lu %6u %6u %6s %6s\n", c.name, info.size, layout.getSize(),
+                info.alignment, layout.getAlignment(), levelsOk ? "ok" : "BAD", layersOk ? "ok" : "BAD");
+        }
+
+        printf("\n%u of %u layouts match\n", unsigned(LayoutCases.size()) - mismatches, unsigned(LayoutCases.size()));
+
+        // In the form the imagelayout host tool keeps its known layouts in
+        printf("\nCaptured: name, size, alignment, layer stride, mip offsets\n");
+        for (unsigned i = 0; i < LayoutCases.size(); i ++)
+        {
+            auto const& c = LayoutCases[i];
+            dk::ImageLayout layout;
+            initLayout(c, layout);
+
+            uint32_t numLevels = ComputeImageLayout(c.params).numLevels;
+            printf("\"%s\", %lu, %u, %lu, {", c.name, layout.getSize(), layout.getAlignment(), probed[i].layerStride);
+            for (uint32_t level = 0; level < numLevels && level < MaxProbedLevels; level ++)
+                printf(" %lu,", probed[i].levelOffsets[level]);
+            printf(" }\n");
+        }
+
+        printf("\nPress PLUS(+) to exit\n");
+    }
+
+    void initLayout(LayoutCase const& c, dk::ImageLayout& layout)
+    {
+        uint32_t flags = 0;
+        if (c.params.pitchStride)
+            flags |= DkImageFlags_PitchLinear;
+        if (c.params.tileSize >= 0)
+            flags |= DkImageFlags_CustomTileSize;
+
+        dk::ImageLayoutMaker maker{device};
+        maker.setFlags(flags)
+            .setType(ImageTypes[c.params.type])
+            .setFormat(c.format)
+            .setDimensions(c.params.width, c.params.height, c.params.depth)
+            .setMipLevels(c.params.mipLevels);
+        if (c.params.pitchStride)
+            maker.setPitchStride(c.params.pitchStride);
+        if (c.params.tileSize >= 0)
+            maker.setTileSize(DkTileSize(c.params.tileSize));
+        maker.initialize(layout);
+    }
+
+    // Copies one compression block of all ones to the top left corner of a mip level of a layer,
+    // into otherwise zeroed memory, and returns where the first set byte landed
+    uint64_t probeOffset(LayoutCase const& c, dk::Image const& image, CMemPool::Handle const& mem, uint32_t level, uint32_t layer)
+    {
+        const u8 zero = 0;
+        StreamFill(mem.getCpuAddr(), &zero, sizeof(zero), mem.getSize());
+
+        uint32_t width = c.params.width >> level ? c.params.width >> level : 1;
+        uint32_t height = c.params.height >> level ? c.params.height >> level : 1;
+        uint32_t blockWidth = c.params.format.blockWidth < width ? c.params.format.blockWidth : width;
+        uint32_t blockHeight = c.params.format.blockHeight < height ? c.params.format.blockHeight : height;
+
+        dk::ImageView view{image};
+        view.setMipLevels(level, 1);
+        view.setLayers(layer, 1);
+
+        cmdbuf.clear();
+        cmdbuf.addMemory(cmdmem.getMemBlock(), cmdmem.getOffset(), cmdmem.getSize());
+        cmdbuf.copyBufferToImage({ marker.getGpuAddr() }, view, { 0, 0, 0, blockWidth, blockHeight, 1 });
+        queue.submitCommands(cmdbuf.finishList());
+        queue.waitIdle();
+
+        auto data = static_cast<u8 const*>(mem.getCpuAddr());
+        for (uint64_t offset = 0; offset < mem.getSize(); offset ++)
+            if (data[offset])
+                return offset;
+        return ~uint64_t(0);
+    }
+
+    void probe(LayoutCase const& c, ImageLayoutInfo const& info, dk::ImageLayout const& layout, Probed& out)
+    {
+        // Pitch linear images and buffers have a single level and layer, there is nothing to find
+        out = Probed{};
+        out.layerStride = layout.getSize();
+        if (!info.isBlockLinear())
+            return;
+
+        CMemPool::Handle mem = pool_probe->allocate(layout.getSize(), layout.getAlignment());
+        dk::Image image;
+        image.initialize(layout, mem.getMemBlock(), mem.getOffset());
+
+        for (uint32_t level = 0; level < info.numLevels && level < MaxProbedLevels; level ++)
+            out.levelOffsets[level] = probeOffset(c, image, mem, level, 0);
+        if (info.numLayers > 1)
+            out.layerStride = probeOffset(c, image, mem, 0, 1);
+
+        mem.destroy();
+    }
+
+    ~Test()
+    {
+        marker.destroy();
+        cmdmem.destroy();
+        consoleExit(NULL);
+    }
+
+    bool onFrame(u64 ns) override
+    {
+        hidScanInput();
+        if (hidKeysDown(CONTROLLER_P1_AUTO) & KEY_PLUS) {
+            return false;
+        }
+        consoleUpdate(NULL);
+        return true;
+    }
+};
+
+} // Anonymous namespace
+
+void Test30()
+{
+    Test app;
+    app.run();
+}
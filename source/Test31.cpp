@@ -0,0 +1,174 @@
+#include "SampleFramework/CExternalImage.h"
+#include "SampleFramework/CReleaseQueue.h"
+#include "SampleFramework/CStagingRing.h"
+#include "SampleFramework/CTextureChecksum.h"
+#include "SampleFramework/CUploadBatch.h"
+#include "SampleFramework/CUploadTicket.h"
+#include "SampleFramework/CApplication.h"
+#include "SampleFramework/CMemPool.h"
+
+#include <array>
+#include <optional>
+
+namespace {
+
+constexpr unsigned NumTextures = 16;
+constexpr unsigned NumIterations = 8;
+
+constexpr const char* TexturePath = "romfs:/cat-256x256.bc1";
+constexpr uint32_t StagingRingSize = 1*1024*1024; // Room for every texture of a batch
+constexpr uint32_t TextureSize = 256;
+constexpr DkImageFormat TextureFormat = DkImageFormat_RGBA_BC1;
+
+class Test final : public CApplication
+{
+    dk::UniqueDevice device;
+    dk::UniqueQueue queue;
+
+    std::optional<CMemPool> pool_images;
+    std::optional<CMemPool> pool_code;
+    std::optional<CMemPool> pool_data;
+    std::optional<CMemPool> pool_readback;
+
+    // Every path draws its first texture with this, and the rendered pixels must come out the same
+    CTextureChecksum checksum;
+
+    CStagingRing ring;
+    std::array<CExternalImage, NumTextures> textures;
+    std::array<CUploadTicket, NumTextures> tickets;
+    CReleaseQueue releaseQueue;
+
+public:
+    Test()
+    {
+        consoleInit(NULL);
+
+        device = dk::DeviceMaker{}.create();
+
+        queue = dk::QueueMaker{device}.setFlags(DkQueueFlags_Graphics).create();
+
+        pool_images.emplace(device, DkMemBlockFlags_GpuCached | DkMemBlockFlags_Image, 16*1024*1024);
+        pool_data.emplace(device, DkMemBlockFlags_CpuUncached | DkMemBlockFlags_GpuCached, 4*1024*1024);
+        pool_code.emplace(device, DkMemBlockFlags_CpuUncached | DkMemBlockFlags_GpuCached | DkMemBlockFlags_Code, 128*1024);
+        pool_readback.emplace(device, DkMemBlockFlags_CpuCached | DkMemBlockFlags_GpuCached | DkMemBlockFlags_Image, 1*1024*1024);
+
+        checksum.allocate(device, *pool_images, *pool_data, *pool_code, *pool_readback, TextureSize, TextureSize);
+        ring.allocate(device, queue, *pool_data, StagingRingSize);
+
+        printf("Loading %u textures from %s, %u iterations\n", NumTextures, TexturePath, NumIterations);
+        printf("Last column: checksum of texture 0 drawn offscreen, same on every line\n\n");
+
+        u64 ticks = 0;
+        unsigned failed = 0;
+        for (unsigned i = 0; i < NumIterations; i ++)
+            ticks += measureBlocking(failed);
+        report("CStagingRing, wait per tex", ticks, failed);
+
+        ticks = 0;
+        failed = 0;
+        for (unsigned i = 0; i < NumIterations; i ++)
+            ticks += measureBatch(failed, [this](CExternalImage& texture, CUploadBatch& batch)
+            {
+                return texture.load(batch, ring, *pool_images, device, TexturePath, TextureSize, TextureSize, TextureFormat);
+            });
+        report("CStagingRing + CUploadBatch", ticks, failed);
+
+        ticks = 0;
+        failed = 0;
+        for (unsigned i = 0; i < NumIterations; i ++)
+            ticks += measureTickets(failed);
+        report("CStagingRing + CUploadTicket", ticks, failed);
+
+        printf("\nPress PLUS(+) to exit\n");
+    }
+
+    ~Test()
+    {
+        queue.waitIdle();
+        releaseQueue.flush();
+        consoleExit(NULL);
+    }
+
+    void report(const char* name, u64 ticks, unsigned failed)
+    {
+        u64 ns = armTicksToNs(ticks / NumIterations);
+        printf("%-28s %6lu us for all, %5lu us/texture, %08X\n", name, ns / 1000, ns / 1000 / NumTextures, drawChecksum(textures[0]));
+        if (failed)
+            printf("  %u loads failed!\n", failed);
+    }
+
+    u64 measureBlocking(unsigned& failed)
+    {
+        u64 start = armGetSystemTick();
+        for (auto& texture : textures)
+            if (!texture.load(ring, *pool_images, device, TexturePath, TextureSize, TextureSize, TextureFormat))
+                failed ++;
+        return armGetSystemTick() - start;
+    }
+
+    uint32_t drawChecksum(CExternalImage& texture)
+    {
+        return texture ? checksum.draw(queue, texture.getDescriptor()) : 0;
+    }
+
+    // Every copy goes into one command list with one fence, which is only waited on once at the end
+    template <typename Load>
+    u64 measureBatch(unsigned& failed, Load&& load)
+    {
+        u64 start = armGetSystemTick();
+        CUploadBatch batch;
+        if (!batch.allocate(device, *pool_data))
+        {
+            failed += NumTextures;
+            return 0;
+        }
+
+        for (auto& texture : textures)
+        {
+            if (batch.isFull())
+            {
+                batch.submit(queue);
+                batch.wait();
+            }
+            if (!load(texture, batch))
+                failed ++;
+        }
+        batch.submit(queue);
+        batch.wait();
+        return armGetSystemTick() - start;
+    }
+
+    // Nothing waits until every load has been submitted. Each texture is loaded twice in a row, so the second
+    // load replaces image memory the first upload may still be writing, which goes through releaseQueue.
+    u64 measureTickets(unsigned& failed)
+    {
+        u64 start = armGetSystemTick();
+        for (unsigned pass = 0; pass < 2; pass ++)
+            for (unsigned i = 0; i < NumTextures; i ++)
+                if (!textures[i].load(tickets[i], releaseQueue, ring, *pool_images, device, TexturePath, TextureSize, TextureSize, TextureFormat))
+                    failed ++;
+
+        for (auto& ticket : tickets)
+            ticket.wait();
+        releaseQueue.poll();
+        return armGetSystemTick() - start;
+    }
+
+    bool onFrame(u64 ns) override
+    {
+        hidScanInput();
+        if (hidKeysDown(CONTROLLER_P1_AUTO) & KEY_PLUS) {
+            return false;
+        }
+        consoleUpdate(NULL);
+        return true;
+    }
+};
+
+} // Anonymous namespace
+
+void Test31()
+{
+    Test app;
+    app.run();
+}
@@ -0,0 +1,198 @@
+#include "SampleFramework/CAssetPack.h"
+#include "SampleFramework/CExternalImage.h"
+#include "SampleFramework/CTextureChecksum.h"
+#include "SampleFramework/CUploadBatch.h"
+#include "SampleFramework/FileLoader.h"
+#include "SampleFramework/CApplication.h"
+#include "SampleFramework/CMemPool.h"
+
+#include <array>
+#include <optional>
+
+namespace {
+
+constexpr unsigned NumTextures = 16;
+constexpr unsigned NumIterations = 8;
+
+constexpr const char* TexturePath = "romfs:/cat-256x256.bc1";
+constexpr const char* PackPath = "romfs:/assets.dkpk";
+constexpr const char* PackTexturePath = "cat-256x256.bc1";
+constexpr uint32_t TextureSize = 256;
+constexpr DkImageFormat TextureFormat = DkImageFormat_RGBA_BC1;
+
+// Pack entries are named by their path relative to the romfs root
+constexpr std::array AssetPaths =
+{
+    "cat-256x256.bc1",
+    "teapot-vtx.bin",
+    "teapot-idx.bin",
+};
+
+class Test final : public CApplication
+{
+    dk::UniqueDevice device;
+    dk::UniqueQueue queue;
+
+    std::optional<CMemPool> pool_images;
+    std::optional<CMemPool> pool_code;
+    std::optional<CMemPool> pool_data;
+    std::optional<CMemPool> pool_readback;
+
+    // Both paths draw their first texture with this, and the rendered pixels must come out the same
+    CTextureChecksum checksum;
+    std::array<CExternalImage, NumTextures> textures;
+
+public:
+    Test()
+    {
+        consoleInit(NULL);
+
+        device = dk::DeviceMaker{}.create();
+
+        queue = dk::QueueMaker{device}.setFlags(DkQueueFlags_Graphics).create();
+
+        pool_images.emplace(device, DkMemBlockFlags_GpuCached | DkMemBlockFlags_Image, 16*1024*1024);
+        pool_data.emplace(device, DkMemBlockFlags_CpuUncached | DkMemBlockFlags_GpuCached, 4*1024*1024);
+        pool_code.emplace(device, DkMemBlockFlags_CpuUncached | DkMemBlockFlags_GpuCached | DkMemBlockFlags_Code, 128*1024);
+        pool_readback.emplace(device, DkMemBlockFlags_CpuCached | DkMemBlockFlags_GpuCached | DkMemBlockFlags_Image, 1*1024*1024);
+
+        checksum.allocate(device, *pool_images, *pool_data, *pool_code, *pool_readback, TextureSize, TextureSize);
+
+        printf("Loading %u textures from %s and from %s, %u iterations\n", NumTextures, TexturePath, PackPath, NumIterations);
+        printf("Last column: checksum of texture 0 drawn offscreen, same on every line\n\n");
+
+        u64 ticks = 0;
+        unsigned failed = 0;
+        for (unsigned i = 0; i < NumIterations; i ++)
+            ticks += measureBatch(failed, [this]
+            {
+                return LoadFile(*pool_data, TexturePath, DK_IMAGE_LINEAR_STRIDE_ALIGNMENT);
+            });
+        report("LoadFile + CUploadBatch", ticks, failed);
+
+        // The pack is opened every iteration, so that the time includes reading its table of contents
+        ticks = 0;
+        failed = 0;
+        for (unsigned i = 0; i < NumIterations; i ++)
+        {
+            u64 start = armGetSystemTick();
+            CAssetPack pack;
+            if (!pack.open(PackPath))
+            {
+                failed += NumTextures;
+                continue;
+            }
+            ticks += armGetSystemTick() - start;
+            ticks += measureBatch(failed, [&]
+            {
+                return pack.load(*pool_data, PackTexturePath, DK_IMAGE_LINEAR_STRIDE_ALIGNMENT);
+            });
+        }
+        report("CAssetPack + CUploadBatch", ticks, failed);
+
+        printf("\nWhole files, loose through LoadFile and out of the open pack:\n");
+        CAssetPack pack;
+        if (pack.open(PackPath))
+            for (const char* path : AssetPaths)
+                measureLoaders(pack, path);
+        else
+            printf("  Could not open %s!\n", PackPath);
+
+        printf("\nPress PLUS(+) to exit\n");
+    }
+
+    ~Test()
+    {
+        queue.waitIdle();
+        consoleExit(NULL);
+    }
+
+    void report(const char* name, u64 ticks, unsigned failed)
+    {
+        u64 ns = armTicksToNs(ticks / NumIterations);
+        uint32_t sum = textures[0] ? checksum.draw(queue, textures[0].getDescriptor()) : 0;
+        printf("%-28s %6lu us for all, %5lu us/texture, %08X\n", name, ns / 1000, ns / 1000 / NumTextures, sum);
+        if (failed)
+            printf("  %u loads failed!\n", failed);
+    }
+
+    template <typename Load>
+    u64 measureLoader(unsigned& failed, Load&& load)
+    {
+        u64 ticks = 0;
+        for (unsigned i = 0; i < NumIterations; i ++)
+        {
+            u64 start = armGetSystemTick();
+            CMemPool::Handle mem = load();
+            ticks += armGetSystemTick() - start;
+            if (!mem)
+                failed ++;
+            mem.destroy();
+        }
+        return ticks / NumIterations;
+    }
+
+    void measureLoaders(CAssetPack& pack, const char* path)
+    {
+        char loosePath[64];
+        snprintf(loosePath, sizeof(loosePath), "romfs:/%s", path);
+
+        unsigned failed = 0;
+        u64 looseTicks = measureLoader(failed, [&] { return LoadFile(*pool_data, loosePath); });
+        u64 packTicks = measureLoader(failed, [&] { return pack.load(*pool_data, path); });
+
+        printf("  %-22s loose %5lu us, pack %5lu us\n", path, armTicksToNs(looseTicks) / 1000, armTicksToNs(packTicks) / 1000);
+        if (failed)
+            printf("  %u loads failed!\n", failed);
+    }
+
+    // Every copy goes into one command list with one fence, which is only waited on once at the end
+    template <typename Load>
+    u64 measureBatch(unsigned& failed, Load&& load)
+    {
+        u64 start = armGetSystemTick();
+        CUploadBatch batch;
+        if (!batch.allocate(device, *pool_data))
+        {
+            failed += NumTextures;
+            return 0;
+        }
+
+        for (auto& texture : textures)
+        {
+            if (batch.isFull())
+            {
+                batch.submit(queue);
+                batch.wait();
+            }
+
+            CMemPool::Handle staging = load();
+            if (!staging || !texture.load(batch, *pool_images, staging, device, TextureSize, TextureSize, TextureFormat))
+            {
+                staging.destroy();
+                failed ++;
+            }
+        }
+        batch.submit(queue);
+        batch.wait();
+        return armGetSystemTick() - start;
+    }
+
+    bool onFrame(u64 ns) override
+    {
+        hidScanInput();
+        if (hidKeysDown(CONTROLLER_P1_AUTO) & KEY_PLUS) {
+            return false;
+        }
+        consoleUpdate(NULL);
+        return true;
+    }
+};
+
+} // Anonymous namespace
+
+void Test33()
+{
+    Test app;
+    app.run();
+}
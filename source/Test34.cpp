@@ -0,0 +1,181 @@
+#include "SampleFramework/CExternalImage.h"
+#include "SampleFramework/CTextureChecksum.h"
+#include "SampleFramework/CUploadBatch.h"
+#include "SampleFramework/FileLoader.h"
+#include "SampleFramework/CApplication.h"
+#include "SampleFramework/CMemPool.h"
+
+#include <array>
+#include <optional>
+
+namespace {
+
+constexpr unsigned NumTextures = 16;
+constexpr unsigned NumIterations = 8;
+
+constexpr const char* TexturePath = "romfs:/cat-256x256.bc1";
+constexpr const char* CompressedTexturePath = "romfs:/cat-256x256.bc1.lz4";
+constexpr uint32_t TextureSize = 256;
+constexpr DkImageFormat TextureFormat = DkImageFormat_RGBA_BC1;
+
+// Every asset is also shipped LZ4-compressed, under the same path with .lz4 appended
+constexpr std::array AssetPaths =
+{
+    "romfs:/cat-256x256.bc1",
+    "romfs:/teapot-vtx.bin",
+    "romfs:/teapot-idx.bin",
+};
+
+class Test final : public CApplication
+{
+    dk::UniqueDevice device;
+    dk::UniqueQueue queue;
+
+    std::optional<CMemPool> pool_images;
+    std::optional<CMemPool> pool_code;
+    std::optional<CMemPool> pool_data;
+    std::optional<CMemPool> pool_readback;
+
+    // Both paths draw their first texture with this, and the rendered pixels must come out the same
+    CTextureChecksum checksum;
+    std::array<CExternalImage, NumTextures> textures;
+
+public:
+    Test()
+    {
+        consoleInit(NULL);
+
+        device = dk::DeviceMaker{}.create();
+
+        queue = dk::QueueMaker{device}.setFlags(DkQueueFlags_Graphics).create();
+
+        pool_images.emplace(device, DkMemBlockFlags_GpuCached | DkMemBlockFlags_Image, 16*1024*1024);
+        pool_data.emplace(device, DkMemBlockFlags_CpuUncached | DkMemBlockFlags_GpuCached, 4*1024*1024);
+        pool_code.emplace(device, DkMemBlockFlags_CpuUncached | DkMemBlockFlags_GpuCached | DkMemBlockFlags_Code, 128*1024);
+        pool_readback.emplace(device, DkMemBlockFlags_CpuCached | DkMemBlockFlags_GpuCached | DkMemBlockFlags_Image, 1*1024*1024);
+
+        checksum.allocate(device, *pool_images, *pool_data, *pool_code, *pool_readback, TextureSize, TextureSize);
+
+        printf("Loading %u textures from %s and %s, %u iterations\n", NumTextures, TexturePath, CompressedTexturePath, NumIterations);
+        printf("Last column: checksum of texture 0 drawn offscreen, same on every line\n\n");
+
+        u64 ticks = 0;
+        unsigned failed = 0;
+        for (unsigned i = 0; i < NumIterations; i ++)
+            ticks += measureBatch(failed, [this]
+            {
+                return LoadFile(*pool_data, TexturePath, DK_IMAGE_LINEAR_STRIDE_ALIGNMENT);
+            });
+        report("LoadFile + CUploadBatch", ticks, failed);
+
+        ticks = 0;
+        failed = 0;
+        for (unsigned i = 0; i < NumIterations; i ++)
+            ticks += measureBatch(failed, [this]
+            {
+                return LoadFileCompressed(*pool_data, CompressedTexturePath, DK_IMAGE_LINEAR_STRIDE_ALIGNMENT);
+            });
+        report("LZ4 + CUploadBatch", ticks, failed);
+
+        printf("\nWhole files, plain and LZ4 into CPU-uncached memory:\n");
+        for (const char* path : AssetPaths)
+            measureLoaders(path);
+
+        printf("\nPress PLUS(+) to exit\n");
+    }
+
+    ~Test()
+    {
+        queue.waitIdle();
+        consoleExit(NULL);
+    }
+
+    void report(const char* name, u64 ticks, unsigned failed)
+    {
+        u64 ns = armTicksToNs(ticks / NumIterations);
+        uint32_t sum = textures[0] ? checksum.draw(queue, textures[0].getDescriptor()) : 0;
+        printf("%-28s %6lu us for all, %5lu us/texture, %08X\n", name, ns / 1000, ns / 1000 / NumTextures, sum);
+        if (failed)
+            printf("  %u loads failed!\n", failed);
+    }
+
+    template <typename Load>
+    u64 measureLoader(unsigned& failed, Load&& load)
+    {
+        u64 ticks = 0;
+        for (unsigned i = 0; i < NumIterations; i ++)
+        {
+            u64 start = armGetSystemTick();
+            CMemPool::Handle mem = load();
+            ticks += armGetSystemTick() - start;
+            if (!mem)
+                failed ++;
+            mem.destroy();
+        }
+        return ticks / NumIterations;
+    }
+
+    void measureLoaders(const char* path)
+    {
+        char compressedPath[64];
+        snprintf(compressedPath, sizeof(compressedPath), "%s.lz4", path);
+
+        unsigned failed = 0;
+        u64 plainTicks = measureLoader(failed, [&] { return LoadFile(*pool_data, path); });
+        u64 lz4Ticks = measureLoader(failed, [&] { return LoadFileCompressed(*pool_data, compressedPath); });
+
+        printf("  %-22s plain %5lu us, LZ4 %5lu us\n", path, armTicksToNs(plainTicks) / 1000, armTicksToNs(lz4Ticks) / 1000);
+        if (failed)
+            printf("  %u loads failed!\n", failed);
+    }
+
+    // Every copy goes into one command list with one fence, which is only waited on once at the end
+    template <typename Load>
+    u64 measureBatch(unsigned& failed, Load&& load)
+    {
+        u64 start = armGetSystemTick();
+        CUploadBatch batch;
+        if (!batch.allocate(device, *pool_data))
+        {
+            failed += NumTextures;
+            return 0;
+        }
+
+        for (auto& texture : textures)
+        {
+            if (batch.isFull())
+            {
+                batch.submit(queue);
+                batch.wait();
+            }
+
+            CMemPool::Handle staging = load();
+            if (!staging || !texture.load(batch, *pool_images, staging, device, TextureSize, TextureSize, TextureFormat))
+            {
+                staging.destroy();
+                failed ++;
+            }
+        }
+        batch.submit(queue);
+        batch.wait();
+        return armGetSystemTick() - start;
+    }
+
+    bool onFrame(u64 ns) override
+    {
+        hidScanInput();
+        if (hidKeysDown(CONTROLLER_P1_AUTO) & KEY_PLUS) {
+            return false;
+        }
+        consoleUpdate(NULL);
+        return true;
+    }
+};
+
+} // Anonymous namespace
+
+void Test34()
+{
+    Test app;
+    app.run();
+}
@@ -33,6 +33,15 @@ void Test22();
 void Test23();
 void Test24();
 void Test25();
+void Test26();
+void Test27();
+void Test28();
+void Test29();
+void Test30();
+void Test31();
+void Test32();
+void Test33();
+void Test34();
 
 namespace
 {
@@ -70,6 +79,15 @@ namespace
         Example{ Test23, "23: Evil aliasing"                           },
         Example{ Test24, "24: Shadow compare R32"                      },
         Example{ Test25, "25: Color sample D32"                        },
+        Example{ Test26, "26: Descriptor update paths benchmark"       },
+        Example{ Test27, "27: Shader loading benchmark"                },
+        Example{ Test28, "28: Staging ring upload benchmark"           },
+        Example{ Test29, "29: Uncached write benchmark"                },
+        Example{ Test30, "30: Image layout calculator check"           },
+        Example{ Test31, "31: Texture upload paths benchmark"          },
+        Example{ Test32, "32: Streamed file loading benchmark"         },
+        Example{ Test33, "33: Asset pack loading benchmark"            },
+        Example{ Test34, "34: LZ4 asset loading benchmark"             },
     };
 }
 
@@ -0,0 +1,214 @@
+/*
+** deko3d Examples - Host tools
+**   dklz4.cpp: Compresses assets for LoadFileCompressed and benchmarks them against raw loads
+**
+** Usage: dklz4 <output> <input>
+**        dklz4 -b <input>...
+** The second form compresses each input in memory and compares the estimated time to load it raw
+** against loading it compressed, at a range of storage bandwidths. Decompression is timed on the
+** host into cached memory; on the console LoadFileCompressed usually targets uncached memory, so
+** treat the decompression figures as an upper bound there.
+*/
+#include "Lz4.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <vector>
+
+namespace
+{
+    constexpr unsigned HashLog = 14;
+    constexpr size_t MinMatch = 4;
+    constexpr size_t MatchLimit = 12; // No match may start within the last 12 bytes
+    constexpr size_t LastLiterals = 5; // The last 5 bytes are always literals
+    constexpr size_t MaxOffset = 65535;
+
+    bool readFile(const char* path, std::vector<uint8_t>& out)
+    {
+        FILE* f = fopen(path, "rb");
+        if (!f) return false;
+
+        fseek(f, 0, SEEK_END);
+        long fsize = ftell(f);
+        rewind(f);
+
+        out.resize(fsize);
+        bool ok = fsize > 0 && fread(out.data(), fsize, 1, f) == 1;
+        fclose(f);
+        return ok;
+    }
+
+    uint32_t read32(uint8_t const* p)
+    {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    void writeLength(std::vector<uint8_t>& out, size_t len)
+    {
+        for (; len >= 255; len -= 255)
+            out.push_back(255);
+        out.push_back(len);
+    }
+
+    void emitSequence(std::vector<uint8_t>& out, uint8_t const* lit, size_t litLen, size_t offset, size_t matchLen)
+    {
+        size_t ml = matchLen ? matchLen - MinMatch : 0;
+        out.push_back((litLen < 15 ? litLen : 15) << 4 | (ml < 15 ? ml : 15));
+        if (litLen >= 15)
+            writeLength(out, litLen - 15);
+        out.insert(out.end(), lit, lit + litLen);
+
+        if (!matchLen)
+            return;
+
+        out.push_back(offset & 0xFF);
+        out.push_back(offset >> 8);
+        if (ml >= 15)
+            writeLength(out, ml - 15);
+    }
+
+    // Greedy single-probe compressor producing standard LZ4 blocks
+    std::vector<uint8_t> compress(std::vector<uint8_t> const& in)
+    {
+        std::vector<uint8_t> out;
+        std::vector<uint32_t> table(1U << HashLog, UINT32_MAX);
+        uint8_t const* src = in.data();
+        size_t n = in.size();
+        size_t anchor = 0, i = 0;
+
+        while (n > MatchLimit && i + MatchLimit <= n)
+        {
+            uint32_t seq = read32(src + i);
+            uint32_t h = (seq * 2654435761U) >> (32 - HashLog);
+            size_t ref = table[h];
+            table[h] = i;
+
+            if (ref == UINT32_MAX || i - ref > MaxOffset || read32(src + ref) != seq)
+            {
+                i ++;
+                continue;
+            }
+
+            size_t len = MinMatch;
+            while (i + len < n - LastLiterals && src[ref + len] == src[i + len])
+                len ++;
+
+            while (i > anchor && ref > 0 && src[i - 1] == src[ref - 1])
+            {
+                i --;
+                ref --;
+                len ++;
+            }
+
+            emitSequence(out, src + anchor, i - anchor, i - ref, len);
+            i += len;
+            anchor = i;
+        }
+
+        emitSequence(out, src + anchor, n - anchor, 0, 0);
+        return out;
+    }
+
+    // Checks the block the same way LoadFileCompressed will use it: in place, at the end of the buffer
+    bool verifyInPlace(std::vector<uint8_t> const& raw, std::vector<uint8_t> const& block)
+    {
+        std::vector<uint8_t> buf(raw.size() + DKLZ_INPLACE_MARGIN(block.size()));
+        if (block.size() > buf.size())
+            return false;
+
+        uint8_t* tail = buf.data() + buf.size() - block.size();
+        memcpy(tail, block.data(), block.size());
+        return Lz4Decompress(tail, block.size(), buf.data(), raw.size()) && memcmp(buf.data(), raw.data(), raw.size()) == 0;
+    }
+
+    int benchmark(int argc, char* argv[])
+    {
+        static const double Bandwidths[] = { 10, 25, 50, 100, 200, 400 }; // MB/s
+        constexpr unsigned NumIterations = 200;
+
+        for (int i = 0; i < argc; i ++)
+        {
+            std::vector<uint8_t> raw;
+            if (!readFile(argv[i], raw))
+            {
+                fprintf(stderr, "%s: could not read file\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+
+            std::vector<uint8_t> block = compress(raw);
+            std::vector<uint8_t> out(raw.size());
+
+            auto start = std::chrono::steady_clock::now();
+            bool ok = true;
+            for (unsigned it = 0; it < NumIterations; it ++)
+                ok &= Lz4Decompress(block.data(), block.size(), out.data(), out.size());
+            double decompSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / NumIterations;
+
+            if (!ok || out != raw)
+            {
+                fprintf(stderr, "%s: round trip failed\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+
+            printf("%s: %zu -> %zu bytes (%.1f%%), decompression %.1f MB/s\n", argv[i], raw.size(), block.size(),
+                100.0 * block.size() / raw.size(), raw.size() / decompSecs / 1e6);
+
+            size_t packed = block.size() + sizeof(DklzHeader);
+            for (double bw : Bandwidths)
+            {
+                double rawMs = raw.size() / (bw * 1e6) * 1e3;
+                double lz4Ms = packed / (bw * 1e6) * 1e3 + decompSecs * 1e3;
+                printf("  %5.0f MB/s: raw %8.3f ms, lz4 %8.3f ms (%s)\n", bw, rawMs, lz4Ms, lz4Ms < rawMs ? "lz4 wins" : "raw wins");
+            }
+        }
+
+        return EXIT_SUCCESS;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc >= 3 && strcmp(argv[1], "-b") == 0)
+        return benchmark(argc - 2, argv + 2);
+
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: %s <output> <input>\n       %s -b <input>...\n", argv[0], argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<uint8_t> raw;
+    if (!readFile(argv[2], raw))
+    {
+        fprintf(stderr, "%s: could not read file\n", argv[2]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<uint8_t> block = compress(raw);
+    if (!verifyInPlace(raw, block))
+    {
+        fprintf(stderr, "%s: compressed data failed to decompress in place\n", argv[2]);
+        return EXIT_FAILURE;
+    }
+
+    DklzHeader hdr = {};
+    hdr.magic = DKLZ_MAGIC;
+    hdr.header_sz = sizeof(DklzHeader);
+    hdr.size = raw.size();
+    hdr.compressed_sz = block.size();
+
+    FILE* f = fopen(argv[1], "wb");
+    if (!f || fwrite(&hdr, sizeof(hdr), 1, f) != 1 || fwrite(block.data(), block.size(), 1, f) != 1)
+    {
+        fprintf(stderr, "%s: could not write file\n", argv[1]);
+        if (f) fclose(f);
+        return EXIT_FAILURE;
+    }
+    fclose(f);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,140 @@
+/*
+** deko3d Examples - Host tools
+**   dkpack.cpp: Packs romfs files into a single asset pack
+**
+** Usage: dkpack <output.dkpk> <root> <input>...
+** Entries are named by their path relative to <root>. DKSH files are aligned for use as
+** shader code, everything else to the linear image stride alignment.
+*/
+#include "AssetPack.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Input
+    {
+        std::string path;
+        uint32_t alignment;
+        std::vector<uint8_t> data;
+    };
+
+    constexpr uint32_t alignUp(uint32_t value, uint32_t align)
+    {
+        return (value + align - 1) &~ (align - 1);
+    }
+
+    bool readFile(const char* path, std::vector<uint8_t>& out)
+    {
+        FILE* f = fopen(path, "rb");
+        if (!f) return false;
+
+        fseek(f, 0, SEEK_END);
+        long fsize = ftell(f);
+        rewind(f);
+
+        out.resize(fsize);
+        bool ok = fsize > 0 && fread(out.data(), fsize, 1, f) == 1;
+        fclose(f);
+        return ok;
+    }
+
+    bool endsWith(std::string const& str, const char* suffix)
+    {
+        size_t len = strlen(suffix);
+        return str.size() >= len && str.compare(str.size() - len, len, suffix) == 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        fprintf(stderr, "Usage: %s <output.dkpk> <root> <input>...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::string root = argv[2];
+    if (!root.empty() && root.back() != '/')
+        root += '/';
+
+    std::vector<Input> inputs;
+    for (int i = 3; i < argc; i ++)
+    {
+        Input in;
+        in.path = argv[i];
+        if (in.path.compare(0, root.size(), root) != 0)
+        {
+            fprintf(stderr, "%s: not inside %s\n", argv[i], argv[2]);
+            return EXIT_FAILURE;
+        }
+        in.path.erase(0, root.size());
+
+        if (in.path.size() >= DKPK_PATH_LEN)
+        {
+            fprintf(stderr, "%s: path too long\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+
+        if (!readFile(argv[i], in.data))
+        {
+            fprintf(stderr, "%s: could not read file\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+
+        in.alignment = endsWith(in.path, ".dksh") ? DKPK_ALIGNMENT_SHADER : DKPK_ALIGNMENT_DEFAULT;
+        inputs.push_back(std::move(in));
+    }
+
+    // The loader looks entries up with a binary search
+    std::sort(inputs.begin(), inputs.end(), [](Input const& a, Input const& b) { return strcmp(a.path.c_str(), b.path.c_str()) < 0; });
+    for (size_t i = 1; i < inputs.size(); i ++)
+    {
+        if (inputs[i].path == inputs[i-1].path)
+        {
+            fprintf(stderr, "Duplicate path: %s\n", inputs[i].path.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    DkpkHeader hdr = {};
+    hdr.magic = DKPK_MAGIC;
+    hdr.header_sz = sizeof(DkpkHeader);
+    hdr.num_entries = inputs.size();
+    hdr.data_off = sizeof(DkpkHeader) + inputs.size()*sizeof(DkpkEntry);
+
+    std::vector<uint8_t> out(hdr.data_off);
+    memcpy(out.data(), &hdr, sizeof(hdr));
+
+    for (size_t i = 0; i < inputs.size(); i ++)
+    {
+        out.resize(alignUp(out.size(), inputs[i].alignment));
+
+        DkpkEntry entry = {};
+        strncpy(entry.path, inputs[i].path.c_str(), DKPK_PATH_LEN - 1);
+        entry.offset = out.size();
+        entry.size = inputs[i].data.size();
+        entry.alignment = inputs[i].alignment;
+        memcpy(out.data() + sizeof(DkpkHeader) + i*sizeof(DkpkEntry), &entry, sizeof(entry));
+
+        out.insert(out.end(), inputs[i].data.begin(), inputs[i].data.end());
+    }
+
+    FILE* f = fopen(argv[1], "wb");
+    if (!f || fwrite(out.data(), out.size(), 1, f) != 1)
+    {
+        fprintf(stderr, "%s: could not write file\n", argv[1]);
+        if (f) fclose(f);
+        return EXIT_FAILURE;
+    }
+    fclose(f);
+
+    printf("Packed %zu files into %s (%zu bytes)\n", inputs.size(), argv[1], out.size());
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,295 @@
+/*
+** deko3d Examples - Host tools
+**   dkshinfo.cpp: Inspects and validates DKSH shader files and shader archives
+**
+** Usage: dkshinfo [-q] [-p <pool size>] [-n <iterations>] <file.dksh|file.dksa>...
+**   -q  Only print problems and the summary
+**   -p  Code pool size the shaders must fit in together (default: 128KiB, as used by the tests)
+**   -n  Number of parse iterations used to measure parse throughput (default: 10000)
+**
+** Exits with a non-zero status if any file is invalid or the shaders don't fit in the pool.
+*/
+#include "Dksh.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// These mirror the values in deko3d.h, which isn't available on the host
+#ifndef DK_SHADER_CODE_ALIGNMENT
+#define DK_SHADER_CODE_ALIGNMENT 0x100
+#endif
+#ifndef DK_SHADER_CODE_UNUSABLE_SIZE
+#define DK_SHADER_CODE_UNUSABLE_SIZE 0x80
+#endif
+
+namespace
+{
+    struct Shader
+    {
+        std::string name;
+        std::vector<uint8_t> const* file;
+        uint32_t offset; // Of the header and control section
+        uint32_t controlSpace; // Bytes available to the control section
+        uint32_t codeSpace; // Bytes available to the code section, which follows the control section in plain files
+        bool archived;
+    };
+
+    struct Stats
+    {
+        uint32_t numPrograms;
+        uint32_t controlSize;
+        uint32_t codeSize;
+    };
+
+    bool g_quiet;
+
+    constexpr uint32_t alignUp(uint32_t value, uint32_t align)
+    {
+        return (value + align - 1) &~ (align - 1);
+    }
+
+    const char* programTypeName(uint32_t type)
+    {
+        switch (type)
+        {
+            case DkshProgramType_Vertex:   return "vert";
+            case DkshProgramType_Fragment: return "frag";
+            case DkshProgramType_Geometry: return "geom";
+            case DkshProgramType_TessCtrl: return "tess_ctrl";
+            case DkshProgramType_TessEval: return "tess_eval";
+            case DkshProgramType_Compute:  return "comp";
+            default:                       return "???";
+        }
+    }
+
+    bool readFile(const char* path, std::vector<uint8_t>& out)
+    {
+        FILE* f = fopen(path, "rb");
+        if (!f) return false;
+
+        fseek(f, 0, SEEK_END);
+        long fsize = ftell(f);
+        rewind(f);
+
+        out.resize(fsize);
+        bool ok = fsize > 0 && fread(out.data(), fsize, 1, f) == 1;
+        fclose(f);
+        return ok;
+    }
+
+    // Validates a DKSH image the same way CShader and CShaderArchive do, returning an error message or nullptr
+    const char* parseDksh(Shader const& s, Stats& stats)
+    {
+        uint8_t const* data = s.file->data() + s.offset;
+        if (s.controlSpace < sizeof(DkshHeader))
+            return "file too small for a DKSH header";
+
+        DkshHeader hdr;
+        memcpy(&hdr, data, sizeof(hdr));
+        if (hdr.magic != DKSH_MAGIC)
+            return "bad magic";
+        if (hdr.header_sz != sizeof(DkshHeader))
+            return "unexpected header size";
+        if (hdr.control_sz & (DK_SHADER_CODE_ALIGNMENT - 1))
+            return "control section not padded to DK_SHADER_CODE_ALIGNMENT";
+        if (hdr.code_sz & (DK_SHADER_CODE_ALIGNMENT - 1))
+            return "code section not padded to DK_SHADER_CODE_ALIGNMENT";
+        if (hdr.control_sz > s.controlSpace)
+            return "control section exceeds the file size";
+        if (hdr.code_sz > (s.archived ? s.codeSpace : s.controlSpace - hdr.control_sz))
+            return "code section exceeds the file size";
+        if (!hdr.num_programs)
+            return "no programs";
+        if (s.archived && hdr.num_programs != 1)
+            return "archived DKSH holds more than one program";
+        if (uint64_t(hdr.programs_off) + uint64_t(hdr.num_programs)*sizeof(DkshProgramHeader) > hdr.control_sz)
+            return "program table exceeds the control section";
+
+        for (uint32_t i = 0; i < hdr.num_programs; i ++)
+        {
+            DkshProgramHeader prog;
+            memcpy(&prog, data + hdr.programs_off + i*sizeof(DkshProgramHeader), sizeof(prog));
+            if (prog.type > DkshProgramType_Compute)
+                return "unknown program type";
+            if (prog.entrypoint >= hdr.code_sz)
+                return "program entrypoint outside of the code section";
+            if (prog.constbuf1_sz && uint64_t(prog.constbuf1_off) + prog.constbuf1_sz > hdr.control_sz)
+                return "constant buffer data outside of the control section";
+        }
+
+        stats.numPrograms = hdr.num_programs;
+        stats.controlSize = hdr.control_sz;
+        stats.codeSize = hdr.code_sz;
+        return nullptr;
+    }
+
+    void printPrograms(uint8_t const* data)
+    {
+        DkshHeader hdr;
+        memcpy(&hdr, data, sizeof(hdr));
+        for (uint32_t i = 0; i < hdr.num_programs; i ++)
+        {
+            DkshProgramHeader prog;
+            memcpy(&prog, data + hdr.programs_off + i*sizeof(DkshProgramHeader), sizeof(prog));
+            printf("    [%u] %-9s entry=0x%05x gprs=%-3u constbuf1=0x%x+0x%x scratch=0x%x\n", i, programTypeName(prog.type),
+                prog.entrypoint, prog.num_gprs, prog.constbuf1_off, prog.constbuf1_sz, prog.per_warp_scratch_sz);
+        }
+    }
+
+    // Splits a file into the DKSH images it contains (one, or one per archive entry)
+    const char* collect(const char* path, std::vector<uint8_t> const& file, std::vector<Shader>& out)
+    {
+        uint32_t magic = 0;
+        if (file.size() >= sizeof(magic))
+            memcpy(&magic, file.data(), sizeof(magic));
+
+        if (magic != DKSA_MAGIC)
+        {
+            out.push_back(Shader{path, &file, 0, uint32_t(file.size()), 0, false});
+            return nullptr;
+        }
+
+        DksaHeader hdr;
+        if (file.size() < sizeof(hdr))
+            return "file too small for an archive header";
+        memcpy(&hdr, file.data(), sizeof(hdr));
+
+        uint64_t controlStart = sizeof(DksaHeader) + uint64_t(hdr.num_entries)*sizeof(DksaEntry);
+        uint64_t codeStart = controlStart + hdr.control_sz;
+        if (hdr.header_sz != sizeof(DksaHeader) || (hdr.code_sz & (DKSA_ALIGNMENT - 1)) || codeStart + hdr.code_sz != file.size())
+            return "bad archive header";
+
+        for (uint32_t i = 0; i < hdr.num_entries; i ++)
+        {
+            DksaEntry entry;
+            memcpy(&entry, file.data() + sizeof(DksaHeader) + i*sizeof(DksaEntry), sizeof(entry));
+            entry.name[DKSA_NAME_LEN-1] = 0;
+            if ((entry.control_off & (DKSA_ALIGNMENT - 1)) || entry.control_off >= hdr.control_sz ||
+                (entry.code_off & (DKSA_ALIGNMENT - 1)) || entry.code_off >= hdr.code_sz)
+                return "archive entry out of bounds or misaligned";
+            if (i && strcmp(out.back().name.c_str() + strlen(path) + 1, entry.name) >= 0)
+                return "archive table of contents not sorted";
+            out.push_back(Shader{std::string{path} + ":" + entry.name, &file, uint32_t(controlStart + entry.control_off),
+                hdr.control_sz - entry.control_off, hdr.code_sz - entry.code_off, true});
+        }
+        return nullptr;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t poolSize = 128*1024;
+    unsigned iterations = 10000;
+
+    int argi = 1;
+    for (; argi < argc && argv[argi][0] == '-'; argi ++)
+    {
+        if (strcmp(argv[argi], "-q") == 0)
+            g_quiet = true;
+        else if (strcmp(argv[argi], "-p") == 0 && argi+1 < argc)
+            poolSize = strtoul(argv[++argi], nullptr, 0);
+        else if (strcmp(argv[argi], "-n") == 0 && argi+1 < argc)
+            iterations = strtoul(argv[++argi], nullptr, 0);
+        else
+            break;
+    }
+
+    if (argi >= argc)
+    {
+        fprintf(stderr, "Usage: %s [-q] [-p <pool size>] [-n <iterations>] <file.dksh|file.dksa>...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    unsigned errors = 0;
+    std::vector<std::vector<uint8_t>> files(argc - argi);
+    std::vector<Shader> shaders;
+
+    auto readStart = std::chrono::steady_clock::now();
+    uint64_t bytesRead = 0;
+    for (int i = argi; i < argc; i ++)
+    {
+        auto& file = files[i - argi];
+        if (!readFile(argv[i], file))
+        {
+            fprintf(stderr, "%s: could not read file\n", argv[i]);
+            errors ++;
+            continue;
+        }
+        bytesRead += file.size();
+
+        if (const char* err = collect(argv[i], file, shaders))
+        {
+            fprintf(stderr, "%s: %s\n", argv[i], err);
+            errors ++;
+        }
+    }
+    double readSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - readStart).count();
+
+    // Code pool usage if every shader is loaded on its own: CShader::load only puts the code section in the pool
+    uint64_t poolUsage = 0;
+    uint32_t largest = 0;
+    for (auto const& s : shaders)
+    {
+        Stats stats;
+        uint8_t const* data = s.file->data() + s.offset;
+        if (const char* err = parseDksh(s, stats))
+        {
+            fprintf(stderr, "%s: %s\n", s.name.c_str(), err);
+            errors ++;
+            continue;
+        }
+
+        poolUsage += alignUp(stats.codeSize, DK_SHADER_CODE_ALIGNMENT);
+        if (stats.codeSize > largest)
+            largest = stats.codeSize;
+
+        if (!g_quiet)
+        {
+            printf("%s: header=%zu control=%u code=%u programs=%u\n", s.name.c_str(),
+                sizeof(DkshHeader), stats.controlSize, stats.codeSize, stats.numPrograms);
+            printPrograms(data);
+        }
+    }
+
+    // Measure parse throughput over the in-memory images
+    uint64_t bytesParsed = 0;
+    unsigned parsed = 0;
+    auto parseStart = std::chrono::steady_clock::now();
+    for (unsigned it = 0; it < iterations; it ++)
+    {
+        for (auto const& s : shaders)
+        {
+            Stats stats;
+            if (!parseDksh(s, stats))
+            {
+                bytesParsed += stats.controlSize;
+                parsed ++;
+            }
+        }
+    }
+    double parseSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - parseStart).count();
+
+    // The last DK_SHADER_CODE_UNUSABLE_SIZE bytes of a code memory block can't hold code
+    uint64_t poolNeeded = poolUsage + DK_SHADER_CODE_UNUSABLE_SIZE;
+
+    printf("\n%zu shaders, %u errors\n", shaders.size(), errors);
+    printf("largest shader code: %u bytes\n", largest);
+    printf("code pool: %llu bytes needed (%llu for shaders + 0x%x unusable), pool size %u\n",
+        (unsigned long long)poolNeeded, (unsigned long long)poolUsage, DK_SHADER_CODE_UNUSABLE_SIZE, poolSize);
+    printf("read:  %.3f ms, %.1f MB/s\n", readSecs*1e3, readSecs > 0 ? bytesRead / readSecs / 1e6 : 0.0);
+    if (parsed)
+        printf("parse: %.1f ns/shader, %.1f MB/s of control data\n", parseSecs*1e9 / parsed, bytesParsed / parseSecs / 1e6);
+
+    if (poolNeeded > poolSize)
+    {
+        fprintf(stderr, "Shaders do not fit in a %u byte code pool\n", poolSize);
+        errors ++;
+    }
+
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
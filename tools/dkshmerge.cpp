@@ -0,0 +1,129 @@
+/*
+** deko3d Examples - Host tools
+**   dkshmerge.cpp: Merges single-stage DKSH files into one multi-program DKSH file
+**
+** Usage: dkshmerge <output.dksh> <input.dksh>...
+**
+** The programs keep the order of the input files, and every program must be for a different stage.
+*/
+#include "Dksh.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+// This mirrors the value in deko3d.h, which isn't available on the host
+#ifndef DK_SHADER_CODE_ALIGNMENT
+#define DK_SHADER_CODE_ALIGNMENT 0x100
+#endif
+
+namespace
+{
+    constexpr uint32_t alignUp(uint32_t value, uint32_t align)
+    {
+        return (value + align - 1) &~ (align - 1);
+    }
+
+    bool readFile(const char* path, std::vector<uint8_t>& out)
+    {
+        FILE* f = fopen(path, "rb");
+        if (!f) return false;
+
+        fseek(f, 0, SEEK_END);
+        long fsize = ftell(f);
+        rewind(f);
+
+        out.resize(fsize);
+        bool ok = fsize > 0 && fread(out.data(), fsize, 1, f) == 1;
+        fclose(f);
+        return ok;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s <output.dksh> <input.dksh>...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<DkshProgramHeader> programs;
+    std::vector<uint8_t> code;
+    uint32_t stages = 0;
+
+    for (int i = 2; i < argc; i ++)
+    {
+        std::vector<uint8_t> data;
+        DkshHeader hdr;
+        if (!readFile(argv[i], data) || data.size() < sizeof(hdr))
+        {
+            fprintf(stderr, "%s: could not read file\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+
+        memcpy(&hdr, data.data(), sizeof(hdr));
+        if (hdr.magic != DKSH_MAGIC || hdr.header_sz != sizeof(DkshHeader) || (hdr.control_sz & (DK_SHADER_CODE_ALIGNMENT - 1)) ||
+            uint64_t(hdr.control_sz) + hdr.code_sz > data.size() ||
+            uint64_t(hdr.programs_off) + uint64_t(hdr.num_programs)*sizeof(DkshProgramHeader) > hdr.control_sz)
+        {
+            fprintf(stderr, "%s: not a valid DKSH file\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+
+        // Entrypoints are relative to the start of the code section, which moves in the merged file
+        uint32_t codeBase = code.size();
+        for (uint32_t j = 0; j < hdr.num_programs; j ++)
+        {
+            DkshProgramHeader prog;
+            memcpy(&prog, data.data() + hdr.programs_off + j*sizeof(DkshProgramHeader), sizeof(prog));
+
+            // Constant buffer 1 data and alternate vertex programs hold offsets this tool doesn't relocate
+            if (prog.constbuf1_sz || (prog.type == DkshProgramType_Vertex && prog.stage_data[1]))
+            {
+                fprintf(stderr, "%s: program %u can't be merged\n", argv[i], j);
+                return EXIT_FAILURE;
+            }
+
+            if (prog.type > DkshProgramType_Compute || (stages & (1U << prog.type)))
+            {
+                fprintf(stderr, "%s: program %u has an unknown or repeated stage\n", argv[i], j);
+                return EXIT_FAILURE;
+            }
+            stages |= 1U << prog.type;
+
+            prog.entrypoint += codeBase;
+            programs.push_back(prog);
+        }
+
+        code.insert(code.end(), data.begin() + hdr.control_sz, data.begin() + hdr.control_sz + hdr.code_sz);
+        code.resize(alignUp(code.size(), DK_SHADER_CODE_ALIGNMENT));
+    }
+
+    DkshHeader hdr = {};
+    hdr.magic = DKSH_MAGIC;
+    hdr.header_sz = sizeof(DkshHeader);
+    hdr.programs_off = sizeof(DkshHeader);
+    hdr.num_programs = programs.size();
+    hdr.control_sz = alignUp(hdr.programs_off + programs.size()*sizeof(DkshProgramHeader), DK_SHADER_CODE_ALIGNMENT);
+    hdr.code_sz = code.size();
+
+    std::vector<uint8_t> out(hdr.control_sz);
+    memcpy(out.data(), &hdr, sizeof(hdr));
+    memcpy(out.data() + hdr.programs_off, programs.data(), programs.size()*sizeof(DkshProgramHeader));
+    out.insert(out.end(), code.begin(), code.end());
+
+    FILE* f = fopen(argv[1], "wb");
+    if (!f || fwrite(out.data(), out.size(), 1, f) != 1)
+    {
+        fprintf(stderr, "%s: could not write file\n", argv[1]);
+        if (f) fclose(f);
+        return EXIT_FAILURE;
+    }
+    fclose(f);
+
+    printf("Merged %u programs into %s (%zu bytes)\n", hdr.num_programs, argv[1], out.size());
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,155 @@
+/*
+** deko3d Examples - Host tools
+**   dkshpack.cpp: Packs DKSH shader files into a single shader archive
+**
+** Usage: dkshpack <output.dksa> <input.dksh>...
+*/
+#include "Dksh.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Input
+    {
+        std::string name;
+        std::vector<uint8_t> data;
+    };
+
+    constexpr uint32_t alignUp(uint32_t value, uint32_t align)
+    {
+        return (value + align - 1) &~ (align - 1);
+    }
+
+    bool readFile(const char* path, std::vector<uint8_t>& out)
+    {
+        FILE* f = fopen(path, "rb");
+        if (!f) return false;
+
+        fseek(f, 0, SEEK_END);
+        long fsize = ftell(f);
+        rewind(f);
+
+        out.resize(fsize);
+        bool ok = fsize > 0 && fread(out.data(), fsize, 1, f) == 1;
+        fclose(f);
+        return ok;
+    }
+
+    std::string entryName(const char* path)
+    {
+        const char* base = strrchr(path, '/');
+        std::string name = base ? base+1 : path;
+        size_t dot = name.rfind(".dksh");
+        if (dot != std::string::npos && dot + 5 == name.size())
+            name.erase(dot);
+        return name;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s <output.dksa> <input.dksh>...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Input> inputs;
+    for (int i = 2; i < argc; i ++)
+    {
+        Input in;
+        in.name = entryName(argv[i]);
+        if (in.name.size() >= DKSA_NAME_LEN)
+        {
+            fprintf(stderr, "%s: name too long\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+
+        if (!readFile(argv[i], in.data) || in.data.size() < sizeof(DkshHeader))
+        {
+            fprintf(stderr, "%s: could not read file\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+
+        DkshHeader hdr;
+        memcpy(&hdr, in.data.data(), sizeof(hdr));
+        if (hdr.magic != DKSH_MAGIC || hdr.control_sz < sizeof(DkshHeader) || (hdr.control_sz & (DKSA_ALIGNMENT - 1)) ||
+            uint64_t(hdr.control_sz) + hdr.code_sz > in.data.size())
+        {
+            fprintf(stderr, "%s: not a valid DKSH file\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+
+        // CShaderArchive hands out one dk::Shader per entry
+        if (hdr.num_programs != 1)
+        {
+            fprintf(stderr, "%s: holds %u programs, archived shaders must hold exactly one\n", argv[i], hdr.num_programs);
+            return EXIT_FAILURE;
+        }
+
+        inputs.push_back(std::move(in));
+    }
+
+    // The loader looks entries up with a binary search
+    std::sort(inputs.begin(), inputs.end(), [](Input const& a, Input const& b) { return a.name < b.name; });
+    for (size_t i = 1; i < inputs.size(); i ++)
+    {
+        if (inputs[i].name == inputs[i-1].name)
+        {
+            fprintf(stderr, "Duplicate shader name: %s\n", inputs[i].name.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Control and code sections are split into two blobs, so that each can be loaded with a single read
+    std::vector<uint8_t> toc(inputs.size()*sizeof(DksaEntry));
+    std::vector<uint8_t> control, code;
+    for (size_t i = 0; i < inputs.size(); i ++)
+    {
+        DkshHeader dksh;
+        memcpy(&dksh, inputs[i].data.data(), sizeof(dksh));
+
+        DksaEntry entry = {};
+        strncpy(entry.name, inputs[i].name.c_str(), DKSA_NAME_LEN - 1);
+        entry.control_off = control.size();
+        entry.code_off = code.size();
+        memcpy(toc.data() + i*sizeof(DksaEntry), &entry, sizeof(entry));
+
+        auto const* data = inputs[i].data.data();
+        control.insert(control.end(), data, data + dksh.control_sz);
+        code.insert(code.end(), data + dksh.control_sz, data + dksh.control_sz + dksh.code_sz);
+        code.resize(alignUp(code.size(), DKSA_ALIGNMENT));
+    }
+
+    DksaHeader hdr = {};
+    hdr.magic = DKSA_MAGIC;
+    hdr.header_sz = sizeof(DksaHeader);
+    hdr.num_entries = inputs.size();
+    hdr.control_sz = control.size();
+    hdr.code_sz = code.size();
+
+    std::vector<uint8_t> out(sizeof(hdr));
+    memcpy(out.data(), &hdr, sizeof(hdr));
+    out.insert(out.end(), toc.begin(), toc.end());
+    out.insert(out.end(), control.begin(), control.end());
+    out.insert(out.end(), code.begin(), code.end());
+
+    FILE* f = fopen(argv[1], "wb");
+    if (!f || fwrite(out.data(), out.size(), 1, f) != 1)
+    {
+        fprintf(stderr, "%s: could not write file\n", argv[1]);
+        if (f) fclose(f);
+        return EXIT_FAILURE;
+    }
+    fclose(f);
+
+    printf("Packed %zu shaders into %s (%zu bytes)\n", inputs.size(), argv[1], out.size());
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,48 @@
+/*
+** deko3d Examples - Host tools
+**   filemapcheck.cpp: Checks that LoadFileMapped returns the same data as LoadFile
+**
+** Usage: filemapcheck <file>...
+**
+** Built against the stand-in platform headers in tools/host, so it exercises the framework's own
+** FileLoader and CMemPool code. Exits with a non-zero status if any file differs.
+*/
+#include "FileLoader.h"
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <file>...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    CMemPool pool{dk::Device{}};
+    unsigned errors = 0;
+    for (int i = 1; i < argc; i ++)
+    {
+        CMemPool::Handle loaded = LoadFile(pool, argv[i]);
+        CMemPool::Handle mapped = LoadFileMapped(pool, argv[i]);
+
+        const char* err = nullptr;
+        if (!loaded || !mapped)
+            err = "could not load file";
+        else if (mapped.getSize() != loaded.getSize())
+            err = "sizes differ";
+        else if (memcmp(mapped.getCpuAddr(), loaded.getCpuAddr(), loaded.getSize()) != 0)
+            err = "contents differ";
+
+        if (err)
+        {
+            fprintf(stderr, "%s: %s\n", argv[i], err);
+            errors ++;
+        }
+        else
+            printf("%s: %u bytes match\n", argv[i], loaded.getSize());
+
+        mapped.destroy();
+        loaded.destroy();
+    }
+
+    return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
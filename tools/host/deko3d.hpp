@@ -0,0 +1,132 @@
+/*
+** deko3d Examples - Host tools
+**   deko3d.hpp: Stand-in for the deko3d header in host builds of CPU-side framework code
+**
+** Only what the framework's file loading and memory pool code needs is here. Memory blocks are plain
+** CPU memory without a GPU address; anything that would submit work to the GPU aborts.
+*/
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef uint64_t DkGpuAddr;
+typedef uintptr_t DkCmdList;
+
+#define DK_GPU_ADDR_INVALID (~0ULL)
+#define DK_MEMBLOCK_ALIGNMENT 0x1000
+#define DK_CMDMEM_ALIGNMENT 4
+#define DK_IMAGE_LINEAR_STRIDE_ALIGNMENT 32
+#define DK_SHADER_CODE_ALIGNMENT 0x100
+#define DK_SHADER_CODE_UNUSABLE_SIZE 0x80
+
+enum DkResult
+{
+    DkResult_Success,
+    DkResult_Fail,
+    DkResult_Timeout,
+};
+
+enum DkMemBlockFlags
+{
+    DkMemBlockFlags_CpuUncached = 1U << 0,
+    DkMemBlockFlags_CpuCached   = 2U << 0,
+    DkMemBlockFlags_GpuUncached = 1U << 2,
+    DkMemBlockFlags_GpuCached   = 2U << 2,
+    DkMemBlockFlags_Code        = 1U << 4,
+    DkMemBlockFlags_Image       = 1U << 5,
+};
+
+struct DkMemBlock_T
+{
+    void* cpuAddr;
+    uint32_t size;
+    bool ownsStorage;
+};
+
+namespace dk
+{
+    [[noreturn]] inline void HostUnsupported(const char* what)
+    {
+        fprintf(stderr, "%s is not available in host builds\n", what);
+        abort();
+    }
+
+    class Device
+    {
+    public:
+        constexpr Device() { }
+    };
+
+    class MemBlock
+    {
+        DkMemBlock_T* m_obj;
+    public:
+        constexpr MemBlock(DkMemBlock_T* obj = nullptr) : m_obj{obj} { }
+        constexpr explicit operator bool() const { return m_obj != nullptr; }
+
+        void* getCpuAddr() const { return m_obj->cpuAddr; }
+        DkGpuAddr getGpuAddr() const { return DK_GPU_ADDR_INVALID; }
+        uint32_t getSize() const { return m_obj->size; }
+
+        void destroy()
+        {
+            if (!m_obj) return;
+            if (m_obj->ownsStorage)
+                ::free(m_obj->cpuAddr);
+            delete m_obj;
+            m_obj = nullptr;
+        }
+    };
+
+    class MemBlockMaker
+    {
+        uint32_t m_size;
+        void* m_storage;
+    public:
+        MemBlockMaker(Device, uint32_t size) : m_size{size}, m_storage{} { }
+        MemBlockMaker& setFlags(uint32_t) { return *this; }
+        MemBlockMaker& setStorage(void* storage) { m_storage = storage; return *this; }
+
+        MemBlock create()
+        {
+            void* storage = m_storage ? m_storage : ::aligned_alloc(DK_MEMBLOCK_ALIGNMENT, m_size);
+            if (!storage) return nullptr;
+            return new DkMemBlock_T{storage, m_size, !m_storage};
+        }
+    };
+
+    // Nothing runs on a GPU here, so fences are never pending
+    class Fence
+    {
+    public:
+        DkResult wait(int64_t timeout_ns = -1) { (void)timeout_ns; return DkResult_Success; }
+    };
+
+    class CmdBuf
+    {
+    public:
+        void clear() { }
+        void addMemory(MemBlock, uint32_t, uint32_t) { HostUnsupported("dk::CmdBuf"); }
+        void copyBuffer(DkGpuAddr, DkGpuAddr, uint32_t) { HostUnsupported("dk::CmdBuf"); }
+        void signalFence(Fence&, bool = false) { HostUnsupported("dk::CmdBuf"); }
+        DkCmdList finishList() { HostUnsupported("dk::CmdBuf"); }
+    };
+
+    using UniqueCmdBuf = CmdBuf;
+
+    class CmdBufMaker
+    {
+    public:
+        CmdBufMaker(Device) { }
+        CmdBuf create() { HostUnsupported("dk::CmdBuf"); }
+    };
+
+    class Queue
+    {
+    public:
+        void submitCommands(DkCmdList) { HostUnsupported("dk::Queue"); }
+        void flush() { HostUnsupported("dk::Queue"); }
+        void waitIdle() { HostUnsupported("dk::Queue"); }
+    };
+}
@@ -0,0 +1,243 @@
+/*
+** deko3d Examples - Host tools
+**   imagelayout.cpp: Prints image memory layouts as deko3d computes them, and checks the layout
+**   calculator against dk::ImageLayout results captured on the console
+**
+** Usage: imagelayout [-t <tile size>] [-p <pitch stride>] <type> <format> <width> [height] [depth] [levels]
+**        imagelayout -v
+**   -t  DkTileSize to use instead of picking one, like DkImageFlags_CustomTileSize
+**   -p  Pitch stride of a pitch linear image, like DkImageFlags_PitchLinear
+**   -v  Only run the checks
+**
+** type is one of 1d, 2d, 3d, 1darray, 2darray, cube, cubearray or buffer, and format one of r8, rg8,
+** rgba8, rgba16, rgba32, bc1, bc3 or astc<w>x<h>. depth counts slices or layers, 6 per cubemap.
+*/
+#include "ImageLayout.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+    struct NamedType
+    {
+        const char* name;
+        ImageLayoutType type;
+    };
+
+    constexpr NamedType Types[] =
+    {
+        { "1d",        ImageLayoutType_1D           },
+        { "2d",        ImageLayoutType_2D           },
+        { "3d",        ImageLayoutType_3D           },
+        { "1darray",   ImageLayoutType_1DArray      },
+        { "2darray",   ImageLayoutType_2DArray      },
+        { "cube",      ImageLayoutType_Cubemap      },
+        { "cubearray", ImageLayoutType_CubemapArray },
+        { "buffer",    ImageLayoutType_Buffer       },
+    };
+
+    struct NamedFormat
+    {
+        const char* name;
+        ImageFormatInfo format;
+    };
+
+    constexpr NamedFormat Formats[] =
+    {
+        { "r8",     ImageFormatInfo_R8     },
+        { "rg8",    ImageFormatInfo_RG8    },
+        { "rgba8",  ImageFormatInfo_RGBA8  },
+        { "rgba16", ImageFormatInfo_RGBA16 },
+        { "rgba32", ImageFormatInfo_RGBA32 },
+        { "bc1",    ImageFormatInfo_BC1    },
+        { "bc3",    ImageFormatInfo_BC3    },
+    };
+
+    constexpr uint32_t MaxKnownLevels = 8;
+
+    // Layouts deko3d produced on the console, as Test30 prints them under "Captured": the size and alignment
+    // dk::ImageLayout reports, and the layer stride and mip offsets found by copying into the image. Zero
+    // means a value wasn't captured and isn't checked. The Test10 face size is the one that test renders
+    // its cubemap with; append Test30's lines here after running it on hardware.
+    struct KnownLayout
+    {
+        const char* name;
+        ImageLayoutParams params;
+        uint64_t size;
+        uint32_t alignment;
+        uint64_t layerStride;
+        uint64_t levelOffsets[MaxKnownLevels];
+    };
+
+    const KnownLayout KnownLayouts[] =
+    {
+        { "Test10 BC3 cubemap", { ImageLayoutType_Cubemap, ImageFormatInfo_BC3, 128, 128, 6, 8 }, 0, 0, 24576, {} },
+    };
+
+    bool parseType(const char* name, ImageLayoutType& type)
+    {
+        for (auto const& t : Types)
+            if (strcmp(name, t.name) == 0)
+            {
+                type = t.type;
+                return true;
+            }
+        return false;
+    }
+
+    bool parseFormat(const char* name, ImageFormatInfo& format)
+    {
+        for (auto const& f : Formats)
+            if (strcmp(name, f.name) == 0)
+            {
+                format = f.format;
+                return true;
+            }
+
+        unsigned w, h;
+        if (sscanf(name, "astc%ux%u", &w, &h) == 2 && w >= 4 && w <= 12 && h >= 4 && h <= 12)
+        {
+            format = ImageFormatInfo_ASTC(w, h);
+            return true;
+        }
+        return false;
+    }
+
+    void print(ImageLayoutInfo const& info, ImageLayoutParams const& params)
+    {
+        if (!info.isBlockLinear())
+        {
+            printf("pitch linear, stride %u, size %llu, alignment %u\n", info.pitchStride,
+                (unsigned long long)info.size, info.alignment);
+            return;
+        }
+
+        printf("tile: %u GOBs tall, %u deep\n", 1U << info.surf.blockHeight, 1U << info.surf.blockDepth);
+        printf("size: %llu, alignment %u, %u layers %llu bytes apart\n", (unsigned long long)info.size,
+            info.alignment, info.numLayers, (unsigned long long)info.layerStride);
+        printf("level     pixels       blocks     tile   offset       size\n");
+        for (uint32_t i = 0; i < info.numLevels; i ++)
+        {
+            SwizzleSurface level = info.getLevel(i);
+            uint32_t w = params.width >> i ? params.width >> i : 1;
+            uint32_t h = params.height >> i ? params.height >> i : 1;
+            printf("%5u %5ux%-5u %5ux%-5u %3u,%-2u %10llu %10llu\n", i, w, h, level.width, level.height,
+                level.blockHeight, level.blockDepth, (unsigned long long)info.getSubresourceOffset(i),
+                (unsigned long long)info.getLevelSize(i));
+        }
+    }
+
+    unsigned checkKnown()
+    {
+        unsigned errors = 0;
+        for (auto const& known : KnownLayouts)
+        {
+            ImageLayoutInfo info = ComputeImageLayout(known.params);
+            bool ok = (!known.size || info.size == known.size) && (!known.alignment || info.alignment == known.alignment) &&
+                (!known.layerStride || info.layerStride == known.layerStride);
+            if (!ok)
+                fprintf(stderr, "%s: got size %llu, alignment %u, layer stride %llu, expected %llu, %u, %llu\n", known.name,
+                    (unsigned long long)info.size, info.alignment, (unsigned long long)info.layerStride,
+                    (unsigned long long)known.size, known.alignment, (unsigned long long)known.layerStride);
+
+            // Level 0 always starts its layer, so a zero offset past it is one that wasn't captured
+            for (uint32_t i = 1; i < info.numLevels && i < MaxKnownLevels; i ++)
+                if (known.levelOffsets[i] && info.getLevelOffset(i) != known.levelOffsets[i])
+                {
+                    fprintf(stderr, "%s: level %u at %llu, expected %llu\n", known.name, i,
+                        (unsigned long long)info.getLevelOffset(i), (unsigned long long)known.levelOffsets[i]);
+                    ok = false;
+                }
+
+            if (!ok)
+                errors ++;
+        }
+        return errors;
+    }
+
+    // Every subresource must start on a whole tile of its own and fit before the next one
+    unsigned checkConsistency(unsigned& checked)
+    {
+        constexpr ImageLayoutType LayoutTypes[] = { ImageLayoutType_2D, ImageLayoutType_3D, ImageLayoutType_2DArray, ImageLayoutType_CubemapArray };
+        constexpr uint32_t Sizes[] = { 1, 3, 8, 17, 64, 100, 256, 1000 };
+
+        unsigned errors = 0;
+        for (ImageLayoutType type : LayoutTypes)
+            for (auto const& f : Formats)
+                for (uint32_t width : Sizes)
+                    for (uint32_t height : Sizes)
+                    {
+                        uint32_t depth = type == ImageLayoutType_CubemapArray ? 12 : type == ImageLayoutType_2D ? 1 : (width % 7) + 1;
+                        uint32_t levels = 1;
+                        while ((width | height) >> levels)
+                            levels ++;
+
+                        ImageLayoutInfo info = ComputeImageLayout({ type, f.format, width, height, depth, levels });
+                        bool ok = info.size == info.layerStride * info.numLayers && info.size % info.alignment == 0;
+                        for (uint32_t i = 0; ok && i < levels; i ++)
+                        {
+                            uint64_t offset = info.getSubresourceOffset(i);
+                            uint64_t end = i + 1 < levels ? info.getSubresourceOffset(i + 1) : info.layerStride;
+                            ok = offset % info.getLevel(i).getBlockSize() == 0 && offset + info.getLevelSize(i) <= end;
+                        }
+                        if (!ok)
+                        {
+                            fprintf(stderr, "Inconsistent layout: type %u, %s, %ux%ux%u\n", unsigned(type), f.name, width, height, depth);
+                            errors ++;
+                        }
+                        checked ++;
+                    }
+        return errors;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    ImageLayoutParams params{};
+    bool verifyOnly = false;
+
+    int argi = 1;
+    for (; argi < argc && argv[argi][0] == '-'; argi ++)
+    {
+        if (strcmp(argv[argi], "-v") == 0)
+            verifyOnly = true;
+        else if (strcmp(argv[argi], "-t") == 0 && argi+1 < argc)
+            params.tileSize = strtol(argv[++argi], nullptr, 0);
+        else if (strcmp(argv[argi], "-p") == 0 && argi+1 < argc)
+            params.pitchStride = strtoul(argv[++argi], nullptr, 0);
+        else
+            break;
+    }
+
+    unsigned checked = 0;
+    unsigned errors = checkKnown() + checkConsistency(checked);
+    if (errors)
+        return EXIT_FAILURE;
+    if (verifyOnly)
+    {
+        printf("Checked %zu known layouts and %u generated ones\n", sizeof(KnownLayouts) / sizeof(KnownLayouts[0]), checked);
+        return EXIT_SUCCESS;
+    }
+
+    if (argc - argi < 3 || !parseType(argv[argi], params.type) || !parseFormat(argv[argi+1], params.format) ||
+        params.tileSize > int32_t(SWIZZLE_MAX_BLOCK_HEIGHT))
+    {
+        fprintf(stderr, "Usage: %s [-t <tile size>] [-p <pitch stride>] <type> <format> <width> [height] [depth] [levels]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    params.width = strtoul(argv[argi+2], nullptr, 0);
+    params.height = argc - argi > 3 ? strtoul(argv[argi+3], nullptr, 0) : 1;
+    params.depth = argc - argi > 4 ? strtoul(argv[argi+4], nullptr, 0) : 1;
+    params.mipLevels = argc - argi > 5 ? strtoul(argv[argi+5], nullptr, 0) : 1;
+    if (!params.width || !params.height || !params.depth)
+    {
+        fprintf(stderr, "Image dimensions must not be zero\n");
+        return EXIT_FAILURE;
+    }
+
+    print(ComputeImageLayout(params), params);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,519 @@
+/*
+** deko3d Examples - Host tools
+**   swizzlebench.cpp: Verifies the block-linear swizzler against a naive reference and benchmarks it
+**   against per-pixel swizzling
+**
+** Usage: swizzlebench [-v] [-s] [-t <threads>]
+**   -v  Only run the verification pass
+**   -s  Only run the verification pass and the thread pool scaling test
+**   -t  Highest thread count for the thread pool scaling test (default: number of host cores, at least 4)
+*/
+#include "Swizzle.h"
+#include "SwizzleThreadPool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t BytesPerPixel[] = { 1, 2, 4, 8, 16 };
+    constexpr uint32_t MaxBlockHeight = 5;
+
+    // Straight from the definition of the layout: a GOB is 64 bytes by 8 rows made of 16 byte by 2 row
+    // sectors, GOBs stack into blocks of 2^blockHeight GOBs and blocks are stored row by row
+    size_t referenceOffset(SwizzleSurface const& surf, uint32_t x, uint32_t y, uint32_t z = 0)
+    {
+        uint32_t xb = x * surf.bytesPerPixel;
+        uint32_t gobsPerBlockY = 1U << surf.blockHeight;
+        uint32_t gobsPerBlockZ = 1U << surf.blockDepth;
+        uint32_t gobsPerBlock = gobsPerBlockY * gobsPerBlockZ;
+        uint32_t blockX = xb / 64;
+        uint32_t blockY = y / (8 * gobsPerBlockY);
+        uint32_t blockZ = z / gobsPerBlockZ;
+        uint32_t gobY = (y / 8) % gobsPerBlockY;
+        uint32_t gobZ = z % gobsPerBlockZ;
+        uint32_t blockRows = (surf.height + 8 * gobsPerBlockY - 1) / (8 * gobsPerBlockY);
+
+        size_t offset = ((size_t(blockZ) * blockRows + blockY) * surf.getGobsPerRow() + blockX) * gobsPerBlock * 512;
+        offset += (gobZ * gobsPerBlockY + gobY) * 512;
+        offset += ((xb % 64) / 32) * 256 + ((y % 8) / 2) * 64 + ((xb % 32) / 16) * 32 + (y % 2) * 16 + xb % 16;
+        return offset;
+    }
+
+    // What the tests used to do: full address math and a small copy for every pixel
+    void swizzlePerPixel(SwizzleSurface const& surf, uint8_t* dst, uint8_t const* src, uint32_t pitch)
+    {
+        for (uint32_t y = 0; y < surf.height; y ++, src += pitch)
+            for (uint32_t x = 0; x < surf.width; x ++)
+                memcpy(dst + surf.getOffset(x, y), src + x*surf.bytesPerPixel, surf.bytesPerPixel);
+    }
+
+    void deswizzlePerPixel(SwizzleSurface const& surf, uint8_t* dst, uint32_t pitch, uint8_t const* src)
+    {
+        for (uint32_t y = 0; y < surf.height; y ++, dst += pitch)
+            for (uint32_t x = 0; x < surf.width; x ++)
+                memcpy(dst + x*surf.bytesPerPixel, src + surf.getOffset(x, y), surf.bytesPerPixel);
+    }
+
+    void fillPattern(std::vector<uint8_t>& buf, uint32_t seed)
+    {
+        for (size_t i = 0; i < buf.size(); i ++)
+        {
+            seed = seed * 1103515245 + 12345;
+            buf[i] = seed >> 16;
+        }
+    }
+
+    bool verifySurface(SwizzleSurface const& surf)
+    {
+        uint32_t pitch = surf.width * surf.bytesPerPixel + 3; // Deliberately not tightly packed
+        std::vector<uint8_t> linear(size_t(pitch) * surf.height);
+        std::vector<uint8_t> tiled(surf.getSize(), 0xCD);
+        std::vector<uint8_t> expected(surf.getSize(), 0xCD);
+        fillPattern(linear, surf.width * 131 + surf.height);
+
+        for (uint32_t y = 0; y < surf.height; y ++)
+            for (uint32_t x = 0; x < surf.width; x ++)
+                memcpy(&expected[referenceOffset(surf, x, y)], &linear[size_t(y)*pitch + x*surf.bytesPerPixel], surf.bytesPerPixel);
+
+        SwizzleImage(surf, tiled.data(), linear.data(), pitch);
+        if (tiled != expected)
+        {
+            fprintf(stderr, "SwizzleImage mismatch: %ux%u bpp=%u blockHeight=%u\n", surf.width, surf.height, surf.bytesPerPixel, surf.blockHeight);
+            return false;
+        }
+
+        // Sub-rectangles straddling GOB boundaries, written over the expected image
+        uint32_t rx = surf.width / 3, ry = surf.height / 4;
+        uint32_t rw = surf.width - rx > 1 ? (surf.width - rx) / 2 + 1 : 1;
+        uint32_t rh = surf.height - ry > 1 ? (surf.height - ry) / 2 + 1 : 1;
+        for (uint32_t rectPitch : { pitch, 0U })
+        {
+            std::vector<uint8_t> rect(size_t(pitch) * rh);
+            fillPattern(rect, rx + ry + rectPitch);
+            for (uint32_t y = 0; y < rh; y ++)
+                for (uint32_t x = 0; x < rw; x ++)
+                    memcpy(&expected[referenceOffset(surf, rx + x, ry + y)], &rect[size_t(y)*rectPitch + x*surf.bytesPerPixel], surf.bytesPerPixel);
+
+            SwizzleRect(surf, tiled.data(), rect.data(), rectPitch, rx, ry, rw, rh);
+            if (tiled != expected)
+            {
+                fprintf(stderr, "SwizzleRect mismatch: %ux%u bpp=%u blockHeight=%u rect=%u,%u %ux%u pitch=%u\n", surf.width, surf.height,
+                    surf.bytesPerPixel, surf.blockHeight, rx, ry, rw, rh, rectPitch);
+                return false;
+            }
+        }
+        SwizzleImage(surf, tiled.data(), linear.data(), pitch);
+
+        std::vector<uint8_t> roundTrip(linear.size());
+        DeswizzleImage(surf, roundTrip.data(), pitch, tiled.data());
+        for (uint32_t y = 0; y < surf.height; y ++)
+        {
+            size_t row = size_t(y) * pitch;
+            if (memcmp(&roundTrip[row], &linear[row], surf.width * surf.bytesPerPixel) != 0)
+            {
+                fprintf(stderr, "DeswizzleImage mismatch: %ux%u bpp=%u blockHeight=%u\n", surf.width, surf.height, surf.bytesPerPixel, surf.blockHeight);
+                return false;
+            }
+        }
+
+        // Reading back a sub-rectangle, into tightly packed rows
+        uint32_t rectPitch = rw * surf.bytesPerPixel;
+        std::vector<uint8_t> rect(size_t(rectPitch) * rh);
+        DeswizzleRect(surf, rect.data(), rectPitch, tiled.data(), rx, ry, rw, rh);
+        for (uint32_t y = 0; y < rh; y ++)
+        {
+            if (memcmp(&rect[size_t(y)*rectPitch], &linear[size_t(ry + y)*pitch + rx*surf.bytesPerPixel], rectPitch) != 0)
+            {
+                fprintf(stderr, "DeswizzleRect mismatch: %ux%u bpp=%u blockHeight=%u rect=%u,%u %ux%u\n", surf.width, surf.height,
+                    surf.bytesPerPixel, surf.blockHeight, rx, ry, rw, rh);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool verifyVolume(SwizzleSurface const& surf)
+    {
+        uint32_t pitch = surf.width * surf.bytesPerPixel;
+        uint32_t slicePitch = pitch * surf.height + 5;
+        std::vector<uint8_t> linear(size_t(slicePitch) * surf.depth);
+        std::vector<uint8_t> tiled(surf.getSize(), 0xCD);
+        std::vector<uint8_t> expected(surf.getSize(), 0xCD);
+        fillPattern(linear, surf.width * 131 + surf.height * 7 + surf.depth);
+
+        for (uint32_t z = 0; z < surf.depth; z ++)
+            for (uint32_t y = 0; y < surf.height; y ++)
+                for (uint32_t x = 0; x < surf.width; x ++)
+                    memcpy(&expected[referenceOffset(surf, x, y, z)], &linear[size_t(z)*slicePitch + y*pitch + x*surf.bytesPerPixel], surf.bytesPerPixel);
+
+        SwizzleBox(surf, tiled.data(), linear.data(), pitch, slicePitch, 0, 0, 0, surf.width, surf.height, surf.depth);
+        if (tiled != expected)
+        {
+            fprintf(stderr, "SwizzleBox mismatch: %ux%ux%u bpp=%u blockHeight=%u blockDepth=%u\n", surf.width, surf.height, surf.depth,
+                surf.bytesPerPixel, surf.blockHeight, surf.blockDepth);
+            return false;
+        }
+
+        std::vector<uint8_t> roundTrip(linear.size());
+        DeswizzleBox(surf, roundTrip.data(), pitch, slicePitch, tiled.data(), 0, 0, 0, surf.width, surf.height, surf.depth);
+        for (uint32_t z = 0; z < surf.depth; z ++)
+        {
+            size_t slice = size_t(z) * slicePitch;
+            if (memcmp(&roundTrip[slice], &linear[slice], size_t(pitch) * surf.height) != 0)
+            {
+                fprintf(stderr, "DeswizzleBox mismatch: %ux%ux%u bpp=%u blockHeight=%u blockDepth=%u\n", surf.width, surf.height, surf.depth,
+                    surf.bytesPerPixel, surf.blockHeight, surf.blockDepth);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool verifyLevels()
+    {
+        // 32x32x32 RGBA8 with 4x16 GOB blocks: the blocks shrink to fit the levels, down to a single GOB at 1x1x1
+        SwizzleSurface surf{32, 32, 4, 2, 32, 4};
+        static const uint32_t Sizes[] = { 131072, 16384, 4096, 2048, 1024, 512 };
+        uint64_t offset = 0;
+        for (uint32_t i = 0; i < 6; i ++)
+        {
+            if (surf.getLevel(i).getSize() != Sizes[i] || surf.getLevelOffset(i) != offset)
+            {
+                fprintf(stderr, "Mip level %u: size %llu at %llu, expected %u at %llu\n", i, (unsigned long long)surf.getLevel(i).getSize(),
+                    (unsigned long long)surf.getLevelOffset(i), Sizes[i], (unsigned long long)offset);
+                return false;
+            }
+            offset += Sizes[i];
+        }
+        if (surf.getLayerStride(6) != 5*32768) // 155136 bytes rounded up to a whole 32KiB block
+        {
+            fprintf(stderr, "Layer stride %llu is not aligned to the block size\n", (unsigned long long)surf.getLayerStride(6));
+            return false;
+        }
+        return true;
+    }
+
+    bool verifyThreaded()
+    {
+        // Tiny tasks so that every block row goes through the pool on its own
+        SwizzleThreadPool pool{4, 1};
+        static const SwizzleSurface Surfaces[] = {
+            { 1000, 777, 4, 4 }, { 129, 65, 16, 0 }, { 33, 47, 1, 5 }, { 40, 36, 4, 1, 21, 2 }, { 17, 9, 8, 0, 33, 5 },
+        };
+        for (auto const& surf : Surfaces)
+        {
+            uint32_t pitch = surf.width * surf.bytesPerPixel + 1;
+            std::vector<uint8_t> linear(size_t(pitch) * surf.height * surf.depth);
+            std::vector<uint8_t> expected(surf.getSize(), 0xCD), tiled(surf.getSize(), 0xCD);
+            fillPattern(linear, surf.width);
+
+            SwizzleImage(surf, expected.data(), linear.data(), pitch);
+            pool.swizzleImage(surf, tiled.data(), linear.data(), pitch);
+            std::vector<uint8_t> roundTrip(linear.size());
+            pool.deswizzleImage(surf, roundTrip.data(), pitch, tiled.data());
+            for (size_t i = 0; i < linear.size(); i += pitch)
+                memset(&roundTrip[i + pitch - 1], linear[i + pitch - 1], 1); // The padding byte is never written
+            if (tiled != expected || roundTrip != linear)
+            {
+                fprintf(stderr, "SwizzleThreadPool mismatch: %ux%ux%u bpp=%u blockHeight=%u blockDepth=%u\n", surf.width, surf.height,
+                    surf.depth, surf.bytesPerPixel, surf.blockHeight, surf.blockDepth);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool verifyRegions()
+    {
+        static const SwizzleSurface Surfaces[] = { { 300, 200, 4, 2 }, { 129, 77, 1, 0 }, { 64, 300, 16, 5 } };
+        for (auto const& surf : Surfaces)
+        {
+            uint32_t pitch = surf.width * surf.bytesPerPixel;
+            std::vector<uint8_t> oldLinear(size_t(pitch) * surf.height), newLinear(oldLinear.size());
+            fillPattern(oldLinear, 1);
+            fillPattern(newLinear, 2);
+
+            std::vector<uint8_t> tiled(surf.getSize()), updated(surf.getSize());
+            SwizzleImage(surf, tiled.data(), oldLinear.data(), pitch);
+            SwizzleImage(surf, updated.data(), newLinear.data(), pitch);
+
+            // Overlapping, clipped and empty regions
+            SwizzleRegion regions[] = {
+                { 3, 5, 20, 9 }, { 10, 7, 30, 40 }, { surf.width - 2, surf.height - 3, 50, 50 }, { 0, 0, 0, 10 }, { 1, 100, 1, 1 },
+            };
+
+            // Every block containing a pixel of a region, and nothing else, must come from the new image
+            std::vector<uint8_t> expected = tiled;
+            uint32_t blockSize = surf.getBlockSize();
+            for (auto const& r : regions)
+                for (uint32_t y = r.y; y < r.y + r.height && y < surf.height; y ++)
+                    for (uint32_t x = r.x; x < r.x + r.width && x < surf.width; x ++)
+                    {
+                        size_t block = surf.getOffset(x, y) / blockSize * blockSize;
+                        memcpy(&expected[block], &updated[block], blockSize);
+                    }
+
+            if (!SwizzleRegions(surf, tiled.data(), newLinear.data(), pitch, regions, sizeof(regions) / sizeof(regions[0])))
+            {
+                fprintf(stderr, "SwizzleRegions rejected bpp=%u\n", surf.bytesPerPixel);
+                return false;
+            }
+
+            // Padding past the right edge of the image is never written
+            for (uint32_t y = 0; y < surf.height; y ++)
+                for (uint32_t xb = pitch; xb < surf.getGobsPerRow() * GOB_SIZE_X; xb ++)
+                {
+                    size_t offset = surf.getRowOffset(y) + SwizzleRowByteOffset(xb, surf.getGobStride());
+                    expected[offset] = tiled[offset];
+                }
+            if (tiled != expected)
+            {
+                fprintf(stderr, "SwizzleRegions mismatch: %ux%u bpp=%u blockHeight=%u\n", surf.width, surf.height, surf.bytesPerPixel, surf.blockHeight);
+                return false;
+            }
+        }
+
+        // Pixels that don't divide the GOB width straddle blocks, those must be rejected untouched
+        SwizzleSurface rgb32{20, 20, 12, 1};
+        std::vector<uint8_t> linear(size_t(rgb32.width) * rgb32.height * rgb32.bytesPerPixel, 1), tiled(rgb32.getSize(), 0);
+        SwizzleRegion all{ 0, 0, rgb32.width, rgb32.height };
+        if (SwizzleRegions(rgb32, tiled.data(), linear.data(), rgb32.width * rgb32.bytesPerPixel, &all, 1) ||
+            std::count(tiled.begin(), tiled.end(), 0) != std::ptrdiff_t(tiled.size()))
+        {
+            fprintf(stderr, "SwizzleRegions accepted 12-byte pixels\n");
+            return false;
+        }
+        return true;
+    }
+
+    bool verify()
+    {
+        // Every combination of format and block height, over sizes straddling GOB and block boundaries
+        static const uint32_t Sizes[] = { 1, 3, 7, 8, 9, 15, 16, 17, 31, 33, 64, 65, 127, 129, 257 };
+        unsigned count = 0;
+        for (uint32_t bpp : BytesPerPixel)
+            for (uint32_t bh = 0; bh <= MaxBlockHeight; bh ++)
+                for (uint32_t w : Sizes)
+                    for (uint32_t h : Sizes)
+                    {
+                        if (!verifySurface(SwizzleSurface{w, h, bpp, bh}))
+                            return false;
+                        count ++;
+                    }
+
+        // Volumes, over every block depth and sizes straddling block boundaries in every direction
+        static const uint32_t VolumeSizes[] = { 1, 7, 9, 33 };
+        for (uint32_t bpp : { 1U, 4U, 16U })
+            for (uint32_t bh = 0; bh <= MaxBlockHeight; bh ++)
+                for (uint32_t bd = 0; bd <= MaxBlockHeight; bd ++)
+                    for (uint32_t w : VolumeSizes)
+                        for (uint32_t h : VolumeSizes)
+                            for (uint32_t d : VolumeSizes)
+                            {
+                                if (!verifyVolume(SwizzleSurface{w, h, bpp, bh, d, bd}))
+                                    return false;
+                                count ++;
+                            }
+
+        if (!verifyLevels() || !verifyThreaded() || !verifyRegions())
+            return false;
+
+        printf("Verified %u surfaces\n", count);
+        return true;
+    }
+
+    template <typename Func>
+    double measure(uint64_t bytes, Func&& func)
+    {
+        // Repeat until at least 100ms have been spent to get a stable number
+        unsigned iterations = 0;
+        auto start = std::chrono::steady_clock::now();
+        double secs;
+        do
+        {
+            func();
+            iterations ++;
+            secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        } while (secs < 0.1);
+        return bytes * iterations / secs / 1e9;
+    }
+
+    // Test03's animation: a trail of 7 coloured 512x512 squares moving around a 4096x4096 texture every 4 frames
+    void animationBenchmark()
+    {
+        constexpr uint32_t Dim = 4096, Square = Dim / 8, TrailLength = 7, PathLength = 28, NumFrames = PathLength * 4;
+        SwizzleSurface surf{Dim, Dim, 4, 4};
+        std::vector<uint8_t> tiled(surf.getSize());
+        std::vector<uint32_t> row(Dim);
+        auto squarePos = [](uint32_t idx) { idx %= PathLength; return idx < 8 ? idx : idx < 15 ? 7 + (idx - 7) * 8 : idx < 22 ? 63 - (idx - 14) : (28 - idx) * 8; };
+        auto fillSquare = [&](uint32_t square, uint32_t color)
+        {
+            std::fill(row.begin(), row.begin() + Square, color);
+            SwizzleRect(surf, tiled.data(), row.data(), 0, (square % 8) * Square, (square / 8) * Square, Square, Square);
+        };
+
+        // Before: every square of the trail is rewritten every frame
+        double before = measure(NumFrames, [&]
+        {
+            for (uint32_t frame = 0; frame < NumFrames; frame ++)
+                for (uint32_t i = 0; i < TrailLength; i ++)
+                    fillSquare(squarePos(frame / 4 + i), 0xFF606060 + i);
+        });
+
+        // After: only squares whose colour changed since the previous frame
+        std::vector<uint32_t> colors(64, 0xFF606060);
+        double after = measure(NumFrames, [&]
+        {
+            for (uint32_t frame = 0; frame < NumFrames; frame ++)
+                for (uint32_t i = 0; i < TrailLength; i ++)
+                {
+                    uint32_t square = squarePos(frame / 4 + i), color = 0xFF606060 + i;
+                    if (colors[square] != color)
+                    {
+                        colors[square] = color;
+                        fillSquare(square, color);
+                    }
+                }
+        });
+
+        // measure() reports units per nanosecond, frames here
+        printf("\nTest03 animation: %.1f us/frame rewriting the whole trail, %.1f us/frame rewriting changed squares\n",
+            1e-3 / before, 1e-3 / after);
+    }
+
+    void benchmark()
+    {
+        static const uint32_t Widths[] = { 256, 1024, 4096 };
+        printf("\n%6s %4s %3s %12s %12s %12s %12s\n", "width", "bpp", "bh", "swz/pixel", "swizzle", "deswz/pixel", "deswizzle");
+        for (uint32_t width : Widths)
+        {
+            for (uint32_t bh = 0; bh <= MaxBlockHeight; bh ++)
+            {
+                SwizzleSurface surf{width, width, 4, bh};
+                uint32_t pitch = surf.width * surf.bytesPerPixel;
+                std::vector<uint8_t> linear(size_t(pitch) * surf.height);
+                std::vector<uint8_t> tiled(surf.getSize());
+                fillPattern(linear, width);
+
+                uint64_t bytes = linear.size();
+                double perPixel = measure(bytes, [&] { swizzlePerPixel(surf, tiled.data(), linear.data(), pitch); });
+                double swz = measure(bytes, [&] { SwizzleImage(surf, tiled.data(), linear.data(), pitch); });
+                double deswzPerPixel = measure(bytes, [&] { deswizzlePerPixel(surf, linear.data(), pitch, tiled.data()); });
+                double deswz = measure(bytes, [&] { DeswizzleImage(surf, linear.data(), pitch, tiled.data()); });
+                printf("%6u %4u %3u %7.2f GB/s %7.2f GB/s %7.2f GB/s %7.2f GB/s\n", width, surf.bytesPerPixel, bh, perPixel, swz, deswzPerPixel, deswz);
+            }
+        }
+
+        // Small rectangles, where per-call setup and partial GOBs matter more than bandwidth
+        printf("\n%4s %3s %12s %12s\n", "bpp", "bh", "16x16 rects", "per pixel");
+        for (uint32_t bpp : BytesPerPixel)
+        {
+            for (uint32_t bh = 0; bh <= MaxBlockHeight; bh += MaxBlockHeight / 2 + 1)
+            {
+                SwizzleSurface surf{512, 512, bpp, bh};
+                uint32_t pitch = 16 * bpp;
+                std::vector<uint8_t> rect(size_t(pitch) * 16);
+                std::vector<uint8_t> tiled(surf.getSize());
+                fillPattern(rect, bpp);
+
+                uint64_t bytes = uint64_t(rect.size()) * 31 * 31;
+                double rects = measure(bytes, [&]
+                {
+                    for (uint32_t y = 0; y < 31; y ++)
+                        for (uint32_t x = 0; x < 31; x ++)
+                            SwizzleRect(surf, tiled.data(), rect.data(), pitch, x * 16 + 3, y * 16 + 5, 16, 16);
+                });
+                double perPixel = measure(bytes, [&]
+                {
+                    for (uint32_t y = 0; y < 31; y ++)
+                        for (uint32_t x = 0; x < 31; x ++)
+                            for (uint32_t j = 0; j < 16; j ++)
+                                for (uint32_t i = 0; i < 16; i ++)
+                                    memcpy(&tiled[surf.getOffset(x * 16 + 3 + i, y * 16 + 5 + j)], &rect[j * pitch + i * bpp], bpp);
+                });
+                printf("%4u %3u %7.2f GB/s %7.2f GB/s\n", bpp, bh, rects, perPixel);
+            }
+        }
+
+        animationBenchmark();
+
+        // Volumes, like the 3D textures of the tests but large enough to time
+        printf("\n%6s %4s %3s %3s %12s %12s\n", "size", "bpp", "bh", "bd", "swizzle", "deswizzle");
+        for (uint32_t bd = 0; bd <= MaxBlockHeight; bd ++)
+        {
+            SwizzleSurface surf{128, 128, 4, 2, 128, bd};
+            uint32_t pitch = surf.width * surf.bytesPerPixel;
+            std::vector<uint8_t> linear(size_t(pitch) * surf.height * surf.depth);
+            std::vector<uint8_t> tiled(surf.getSize());
+            fillPattern(linear, bd);
+
+            uint64_t bytes = linear.size();
+            double swz = measure(bytes, [&] { SwizzleImage(surf, tiled.data(), linear.data(), pitch); });
+            double deswz = measure(bytes, [&] { DeswizzleImage(surf, linear.data(), pitch, tiled.data()); });
+            printf("%6u %4u %3u %3u %7.2f GB/s %7.2f GB/s\n", surf.width, surf.bytesPerPixel, surf.blockHeight, bd, swz, deswz);
+        }
+    }
+
+    // Scaling of the thread pool on a 4096x4096 RGBA8 image, the size of Test03's texture. Counts past the
+    // number of host cores are still run, they show what oversubscription costs.
+    void scalingBenchmark(unsigned maxThreads)
+    {
+        SwizzleSurface surf{4096, 4096, 4, 4};
+        uint32_t pitch = surf.width * surf.bytesPerPixel;
+        std::vector<uint8_t> linear(size_t(pitch) * surf.height);
+        std::vector<uint8_t> tiled(surf.getSize());
+        fillPattern(linear, 4096);
+
+        printf("\nThread pool scaling, %u host cores\n", std::thread::hardware_concurrency());
+        printf("%7s %12s %8s %12s %8s\n", "threads", "swizzle", "speedup", "deswizzle", "speedup");
+        double swzBase = 0, deswzBase = 0;
+        for (unsigned threads = 1; threads <= maxThreads; threads ++)
+        {
+            SwizzleThreadPool pool{threads};
+            double swz = measure(linear.size(), [&] { pool.swizzleImage(surf, tiled.data(), linear.data(), pitch); });
+            double deswz = measure(linear.size(), [&] { pool.deswizzleImage(surf, linear.data(), pitch, tiled.data()); });
+            if (threads == 1)
+            {
+                swzBase = swz;
+                deswzBase = deswz;
+            }
+            printf("%7u %7.2f GB/s %7.2fx %7.2f GB/s %7.2fx\n", threads, swz, swz / swzBase, deswz, deswz / deswzBase);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    bool verifyOnly = false, scalingOnly = false;
+    unsigned maxThreads = std::max(std::thread::hardware_concurrency(), 4U);
+    for (int i = 1; i < argc; i ++)
+    {
+        if (strcmp(argv[i], "-v") == 0)
+            verifyOnly = true;
+        else if (strcmp(argv[i], "-s") == 0)
+            scalingOnly = true;
+        else if (strcmp(argv[i], "-t") == 0 && i+1 < argc)
+            maxThreads = strtoul(argv[++i], nullptr, 0);
+        else
+        {
+            fprintf(stderr, "Usage: %s [-v] [-s] [-t <threads>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!verify())
+        return EXIT_FAILURE;
+
+    if (!verifyOnly && !scalingOnly)
+        benchmark();
+    if (!verifyOnly)
+        scalingBenchmark(maxThreads ? maxThreads : 1);
+
+    return EXIT_SUCCESS;
+}